@@ -0,0 +1,1136 @@
+#include "arrow_ipc.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace df {
+namespace arrow_ipc {
+
+namespace {
+
+const char kMagic[] = "ARROW1";
+const std::size_t kMagicSize = 6;
+const std::uint32_t kContinuation = 0xFFFFFFFFu;
+const std::int16_t kMetadataV5 = 4;
+
+// Flatbuffer union tags used below (Schema.fbs / Message.fbs).
+const std::uint8_t kTypeInt = 2;
+const std::uint8_t kTypeFloatingPoint = 3;
+const std::uint8_t kTypeUtf8 = 5;
+const std::uint8_t kTypeDate = 8;
+const std::uint8_t kTypeTimestamp = 10;
+const std::uint8_t kTypeLargeUtf8 = 20;
+const std::uint8_t kHeaderSchema = 1;
+const std::uint8_t kHeaderDictionaryBatch = 2;
+const std::uint8_t kHeaderRecordBatch = 3;
+
+void require_little_endian() {
+  const std::uint16_t probe = 1;
+  std::uint8_t first = 0;
+  std::memcpy(&first, &probe, 1);
+  if (first != 1) {
+    throw std::runtime_error("arrow_ipc: big-endian hosts are not supported");
+  }
+}
+
+std::size_t padded8(std::size_t n) { return (n + 7) & ~static_cast<std::size_t>(7); }
+
+// Minimal flatbuffer builder. Like the reference implementation it fills the
+// buffer back to front, so children are written before the tables that point
+// at them and every uoffset points forward. Objects are identified by their
+// distance from the end of the buffer, which stays valid as the buffer grows.
+class FlatBuilder {
+ public:
+  using Offset = std::size_t;
+
+  FlatBuilder() : buf_(256), head_(buf_.size()) {}
+
+  std::size_t size() const { return buf_.size() - head_; }
+
+  template <typename T>
+  void push(T value) {
+    prep(sizeof(T), 0);
+    push_bytes(&value, sizeof(T));
+  }
+
+  Offset create_string(const std::string& value) {
+    prep(4, value.size() + 1);
+    const char zero = 0;
+    push_bytes(&zero, 1);
+    push_bytes(value.data(), value.size());
+    push<std::uint32_t>(static_cast<std::uint32_t>(value.size()));
+    return size();
+  }
+
+  Offset create_struct_vector(const void* data, std::size_t count, std::size_t elem_size) {
+    const std::size_t bytes = count * elem_size;
+    prep(4, bytes);
+    prep(8, bytes);
+    push_bytes(data, bytes);
+    push<std::uint32_t>(static_cast<std::uint32_t>(count));
+    return size();
+  }
+
+  Offset create_offset_vector(const std::vector<Offset>& offsets) {
+    prep(4, offsets.size() * 4);
+    for (std::size_t i = offsets.size(); i-- > 0;) push_offset(offsets[i]);
+    push<std::uint32_t>(static_cast<std::uint32_t>(offsets.size()));
+    return size();
+  }
+
+  void start_table() {
+    fields_.clear();
+    table_start_ = size();
+  }
+
+  template <typename T>
+  void add_scalar(int slot, T value) {
+    push<T>(value);
+    record(slot);
+  }
+
+  void add_offset(int slot, Offset target) {
+    push_offset(target);
+    record(slot);
+  }
+
+  Offset end_table() {
+    push<std::int32_t>(0);  // soffset to the vtable, patched below
+    const std::size_t table_pos = size();
+    int slots = 0;
+    for (const auto& field : fields_) slots = std::max(slots, field.first + 1);
+    std::vector<std::uint16_t> entries(static_cast<std::size_t>(slots), 0);
+    for (const auto& field : fields_) {
+      entries[static_cast<std::size_t>(field.first)] =
+          static_cast<std::uint16_t>(table_pos - field.second);
+    }
+    for (std::size_t i = entries.size(); i-- > 0;) push<std::uint16_t>(entries[i]);
+    push<std::uint16_t>(static_cast<std::uint16_t>(table_pos - table_start_));
+    push<std::uint16_t>(static_cast<std::uint16_t>(4 + 2 * entries.size()));
+    const std::int32_t vtable_distance = static_cast<std::int32_t>(size() - table_pos);
+    std::memcpy(&buf_[buf_.size() - table_pos], &vtable_distance, 4);
+    return table_pos;
+  }
+
+  std::vector<std::uint8_t> finish(Offset root) {
+    prep(8, 4);
+    push_offset(root);
+    return std::vector<std::uint8_t>(buf_.begin() + static_cast<std::ptrdiff_t>(head_), buf_.end());
+  }
+
+ private:
+  void ensure(std::size_t n) {
+    if (head_ >= n) return;
+    const std::size_t used = size();
+    std::size_t capacity = buf_.size() * 2;
+    while (capacity < used + n) capacity *= 2;
+    std::vector<std::uint8_t> grown(capacity);
+    std::memcpy(&grown[capacity - used], &buf_[head_], used);
+    buf_.swap(grown);
+    head_ = capacity - used;
+  }
+
+  void push_bytes(const void* data, std::size_t n) {
+    ensure(n);
+    head_ -= n;
+    if (n > 0) std::memcpy(&buf_[head_], data, n);
+  }
+
+  // Pads so that after writing `additional` more bytes the size is a
+  // multiple of align (sizes are aligned, and so are final addresses, because
+  // finish() rounds the whole buffer up to 8 bytes).
+  void prep(std::size_t align, std::size_t additional) {
+    const std::size_t pad = (align - ((size() + additional) % align)) % align;
+    ensure(pad);
+    head_ -= pad;
+    std::memset(&buf_[head_], 0, pad);
+  }
+
+  void push_offset(Offset target) {
+    prep(4, 0);
+    push<std::uint32_t>(static_cast<std::uint32_t>(size() + 4 - target));
+  }
+
+  void record(int slot) { fields_.emplace_back(slot, size()); }
+
+  std::vector<std::uint8_t> buf_;
+  std::size_t head_;
+  std::size_t table_start_ = 0;
+  std::vector<std::pair<int, std::size_t>> fields_;
+};
+
+// Read-only flatbuffer access with bounds checks against the enclosing span.
+struct Span {
+  const std::uint8_t* data = nullptr;
+  std::size_t size = 0;
+
+  template <typename T>
+  T read(std::size_t pos) const {
+    if (pos > size || size - pos < sizeof(T)) {
+      throw std::runtime_error("arrow_ipc: truncated or corrupt metadata");
+    }
+    T value;
+    std::memcpy(&value, data + pos, sizeof(T));
+    return value;
+  }
+};
+
+struct Vector {
+  std::size_t pos = 0;  // first element
+  std::size_t count = 0;
+};
+
+class Table {
+ public:
+  Table() = default;
+  Table(const Span& span, std::size_t pos) : span_(span), pos_(pos) {
+    const std::int32_t distance = span.read<std::int32_t>(pos);
+    const long long vtable = static_cast<long long>(pos) - distance;
+    if (vtable < 0) throw std::runtime_error("arrow_ipc: corrupt vtable offset");
+    vtable_ = static_cast<std::size_t>(vtable);
+    vtable_size_ = span.read<std::uint16_t>(vtable_);
+  }
+
+  static Table root(const Span& span) { return Table(span, span.read<std::uint32_t>(0)); }
+
+  bool has(int slot) const { return field(slot) != 0; }
+
+  template <typename T>
+  T scalar(int slot, T fallback) const {
+    const std::size_t pos = field(slot);
+    return pos ? span_.read<T>(pos) : fallback;
+  }
+
+  Table table(int slot) const {
+    const std::size_t pos = target(slot);
+    if (!pos) throw std::runtime_error("arrow_ipc: missing required table");
+    return Table(span_, pos);
+  }
+
+  std::string string(int slot) const {
+    const std::size_t pos = target(slot);
+    if (!pos) return std::string();
+    const std::uint32_t length = span_.read<std::uint32_t>(pos);
+    if (pos + 4 > span_.size || span_.size - pos - 4 < length) {
+      throw std::runtime_error("arrow_ipc: truncated string");
+    }
+    return std::string(reinterpret_cast<const char*>(span_.data + pos + 4), length);
+  }
+
+  Vector vector(int slot) const {
+    const std::size_t pos = target(slot);
+    if (!pos) return Vector();
+    Vector out;
+    out.count = span_.read<std::uint32_t>(pos);
+    out.pos = pos + 4;
+    return out;
+  }
+
+  Table table_at(const Vector& vec, std::size_t i) const {
+    const std::size_t pos = vec.pos + 4 * i;
+    return Table(span_, pos + span_.read<std::uint32_t>(pos));
+  }
+
+  const Span& span() const { return span_; }
+
+ private:
+  std::size_t field(int slot) const {
+    const std::size_t entry = 4 + 2 * static_cast<std::size_t>(slot);
+    if (entry + 2 > vtable_size_) return 0;
+    const std::uint16_t offset = span_.read<std::uint16_t>(vtable_ + entry);
+    return offset ? pos_ + offset : 0;
+  }
+
+  std::size_t target(int slot) const {
+    const std::size_t pos = field(slot);
+    return pos ? pos + span_.read<std::uint32_t>(pos) : 0;
+  }
+
+  Span span_;
+  std::size_t pos_ = 0;
+  std::size_t vtable_ = 0;
+  std::uint16_t vtable_size_ = 0;
+};
+
+#pragma pack(push, 1)
+struct FieldNode {
+  std::int64_t length;
+  std::int64_t null_count;
+};
+struct BufferSpec {
+  std::int64_t offset;
+  std::int64_t length;
+};
+struct Block {
+  std::int64_t offset;
+  std::int32_t metadata_length;
+  std::int32_t padding;
+  std::int64_t body_length;
+};
+#pragma pack(pop)
+
+FlatBuilder::Offset build_int_type(FlatBuilder& fb, std::int32_t bit_width, bool is_signed) {
+  fb.start_table();
+  fb.add_scalar<std::int32_t>(0, bit_width);
+  fb.add_scalar<std::uint8_t>(1, is_signed ? 1 : 0);
+  return fb.end_table();
+}
+
+FlatBuilder::Offset build_schema(FlatBuilder& fb, const std::vector<WriteField>& fields) {
+  std::vector<FlatBuilder::Offset> field_offsets;
+  std::int64_t next_dictionary = 0;
+  for (const auto& field : fields) {
+    const FlatBuilder::Offset name = fb.create_string(field.name);
+    const FlatBuilder::Offset children = fb.create_offset_vector({});
+    std::uint8_t type_tag = 0;
+    FlatBuilder::Offset type = 0;
+    FlatBuilder::Offset dictionary = 0;
+    switch (field.type) {
+      case ColumnType::float64:
+        fb.start_table();
+        fb.add_scalar<std::int16_t>(0, 2);  // Precision::DOUBLE
+        type = fb.end_table();
+        type_tag = kTypeFloatingPoint;
+        break;
+      case ColumnType::int64:
+        type = build_int_type(fb, 64, true);
+        type_tag = kTypeInt;
+        break;
+      case ColumnType::date32:
+        fb.start_table();
+        fb.add_scalar<std::int16_t>(0, 0);  // DateUnit::DAY
+        type = fb.end_table();
+        type_tag = kTypeDate;
+        break;
+      case ColumnType::timestamp_seconds:
+        fb.start_table();
+        fb.add_scalar<std::int16_t>(0, 0);  // TimeUnit::SECOND
+        type = fb.end_table();
+        type_tag = kTypeTimestamp;
+        break;
+      case ColumnType::dictionary_utf8: {
+        fb.start_table();
+        type = fb.end_table();
+        type_tag = kTypeUtf8;
+        const FlatBuilder::Offset index_type = build_int_type(fb, 32, true);
+        fb.start_table();
+        fb.add_scalar<std::int64_t>(0, next_dictionary++);
+        fb.add_offset(1, index_type);
+        dictionary = fb.end_table();
+        break;
+      }
+    }
+    fb.start_table();
+    fb.add_offset(0, name);
+    fb.add_scalar<std::uint8_t>(1, 1);  // nullable
+    fb.add_scalar<std::uint8_t>(2, type_tag);
+    fb.add_offset(3, type);
+    if (dictionary) fb.add_offset(4, dictionary);
+    fb.add_offset(5, children);
+    field_offsets.push_back(fb.end_table());
+  }
+  const FlatBuilder::Offset field_vector = fb.create_offset_vector(field_offsets);
+  fb.start_table();
+  fb.add_scalar<std::int16_t>(0, 0);  // Endianness::Little
+  fb.add_offset(1, field_vector);
+  return fb.end_table();
+}
+
+std::vector<std::uint8_t> build_message(FlatBuilder& fb,
+                                        std::uint8_t header_tag,
+                                        FlatBuilder::Offset header,
+                                        std::int64_t body_length) {
+  fb.start_table();
+  fb.add_scalar<std::int16_t>(0, kMetadataV5);
+  fb.add_scalar<std::uint8_t>(1, header_tag);
+  fb.add_offset(2, header);
+  fb.add_scalar<std::int64_t>(3, body_length);
+  return fb.finish(fb.end_table());
+}
+
+FlatBuilder::Offset build_record_batch(FlatBuilder& fb,
+                                       std::int64_t length,
+                                       const std::vector<FieldNode>& nodes,
+                                       const std::vector<BufferSpec>& buffers) {
+  const FlatBuilder::Offset node_vector =
+      fb.create_struct_vector(nodes.data(), nodes.size(), sizeof(FieldNode));
+  const FlatBuilder::Offset buffer_vector =
+      fb.create_struct_vector(buffers.data(), buffers.size(), sizeof(BufferSpec));
+  fb.start_table();
+  fb.add_scalar<std::int64_t>(0, length);
+  fb.add_offset(1, node_vector);
+  fb.add_offset(2, buffer_vector);
+  return fb.end_table();
+}
+
+std::size_t physical_width(ColumnType type) {
+  switch (type) {
+    case ColumnType::float64:
+    case ColumnType::int64:
+    case ColumnType::timestamp_seconds:
+      return 8;
+    case ColumnType::date32:
+    case ColumnType::dictionary_utf8:
+      return 4;
+  }
+  return 8;
+}
+
+// Memory-mapped read-only file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+#if defined(_WIN32)
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error("arrow_ipc: unable to open file");
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_, &file_size)) {
+      CloseHandle(file_);
+      throw std::runtime_error("arrow_ipc: unable to stat file");
+    }
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+    if (size_ > 0) {
+      mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (!mapping_) {
+        CloseHandle(file_);
+        throw std::runtime_error("arrow_ipc: unable to map file");
+      }
+      data_ = static_cast<const std::uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+      if (!data_) {
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+        throw std::runtime_error("arrow_ipc: unable to map file");
+      }
+    }
+#else
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      throw std::runtime_error("arrow_ipc: unable to open file");
+    }
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) {
+      ::close(fd_);
+      throw std::runtime_error("arrow_ipc: unable to stat file");
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ > 0) {
+      void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (mapped == MAP_FAILED) {
+        ::close(fd_);
+        throw std::runtime_error("arrow_ipc: unable to map file");
+      }
+      data_ = static_cast<const std::uint8_t*>(mapped);
+    }
+#endif
+  }
+
+  ~MappedFile() {
+#if defined(_WIN32)
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    if (data_) ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    ::close(fd_);
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const std::uint8_t* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  const std::uint8_t* data_ = nullptr;
+  std::size_t size_ = 0;
+#if defined(_WIN32)
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+};
+
+// Pulls the first string entry of "index_columns" out of pandas' schema
+// metadata JSON; RangeIndex descriptions (objects) are ignored.
+std::string pandas_index_from_metadata(const std::string& json) {
+  const std::size_t key = json.find("\"index_columns\"");
+  if (key == std::string::npos) return std::string();
+  std::size_t pos = json.find('[', key);
+  if (pos == std::string::npos) return std::string();
+  ++pos;
+  while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\n' || json[pos] == '\t')) ++pos;
+  if (pos >= json.size() || json[pos] != '"') return std::string();
+  std::string name;
+  for (++pos; pos < json.size() && json[pos] != '"'; ++pos) {
+    if (json[pos] == '\\' && pos + 1 < json.size()) ++pos;
+    name += json[pos];
+  }
+  return name;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------- writer --
+
+struct FileWriter::State {
+  std::ofstream out;
+  std::vector<WriteField> fields;
+  std::int64_t position = 0;
+  std::vector<Block> dictionaries;
+  std::vector<Block> batches;
+  bool closed = false;
+
+  void write_bytes(const void* data, std::size_t n) {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(n));
+    if (!out) throw std::runtime_error("arrow_ipc: write failed");
+    position += static_cast<std::int64_t>(n);
+  }
+
+  void write_padding(std::size_t n) {
+    static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    write_bytes(zeros, n);
+  }
+
+  // Encapsulated message: continuation marker, metadata length, flatbuffer
+  // padded to 8 bytes. The caller writes body_length bytes of body next.
+  Block write_metadata(const std::vector<std::uint8_t>& metadata, std::int64_t body_length) {
+    Block block{};
+    block.offset = position;
+    const std::size_t padded = padded8(metadata.size());
+    const std::int32_t length = static_cast<std::int32_t>(padded);
+    write_bytes(&kContinuation, 4);
+    write_bytes(&length, 4);
+    write_bytes(metadata.data(), metadata.size());
+    write_padding(padded - metadata.size());
+    block.metadata_length = static_cast<std::int32_t>(8 + padded);
+    block.body_length = body_length;
+    return block;
+  }
+};
+
+FileWriter::FileWriter(const std::string& path, std::vector<WriteField> fields)
+    : state_(new State) {
+  require_little_endian();
+  if (fields.empty()) {
+    throw std::runtime_error("arrow_ipc: schema has no fields");
+  }
+  state_->fields = std::move(fields);
+  state_->out.open(path, std::ios::binary | std::ios::trunc);
+  if (!state_->out) {
+    throw std::runtime_error("arrow_ipc: unable to open file for writing");
+  }
+  state_->write_bytes(kMagic, kMagicSize);
+  state_->write_padding(2);
+
+  FlatBuilder schema_builder;
+  const FlatBuilder::Offset schema = build_schema(schema_builder, state_->fields);
+  state_->write_metadata(build_message(schema_builder, kHeaderSchema, schema, 0), 0);
+
+  // One dictionary batch per dictionary-encoded field: validity (none),
+  // int32 offsets and the concatenated utf8 bytes.
+  std::int64_t dictionary_id = 0;
+  for (const auto& field : state_->fields) {
+    if (field.type != ColumnType::dictionary_utf8) continue;
+    std::vector<std::int32_t> offsets(field.dictionary.size() + 1, 0);
+    std::string bytes;
+    for (std::size_t i = 0; i < field.dictionary.size(); ++i) {
+      bytes += field.dictionary[i];
+      offsets[i + 1] = static_cast<std::int32_t>(bytes.size());
+    }
+    const std::size_t offsets_size = offsets.size() * 4;
+    std::vector<BufferSpec> buffers = {
+        {0, 0},
+        {0, static_cast<std::int64_t>(offsets_size)},
+        {static_cast<std::int64_t>(padded8(offsets_size)), static_cast<std::int64_t>(bytes.size())}};
+    const std::int64_t body_length =
+        static_cast<std::int64_t>(padded8(offsets_size) + padded8(bytes.size()));
+    const std::int64_t count = static_cast<std::int64_t>(field.dictionary.size());
+
+    FlatBuilder fb;
+    const FlatBuilder::Offset data = build_record_batch(fb, count, {{count, 0}}, buffers);
+    fb.start_table();
+    fb.add_scalar<std::int64_t>(0, dictionary_id++);
+    fb.add_offset(1, data);
+    const FlatBuilder::Offset batch = fb.end_table();
+    Block block =
+        state_->write_metadata(build_message(fb, kHeaderDictionaryBatch, batch, body_length), body_length);
+    state_->write_bytes(offsets.data(), offsets_size);
+    state_->write_padding(padded8(offsets_size) - offsets_size);
+    state_->write_bytes(bytes.data(), bytes.size());
+    state_->write_padding(padded8(bytes.size()) - bytes.size());
+    state_->dictionaries.push_back(block);
+  }
+}
+
+FileWriter::~FileWriter() {
+  if (state_ && !state_->closed) {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+}
+
+void FileWriter::write_batch(std::size_t length, const std::vector<WriteColumn>& columns) {
+  if (state_->closed) {
+    throw std::runtime_error("arrow_ipc: writer is closed");
+  }
+  if (columns.size() != state_->fields.size()) {
+    throw std::runtime_error("arrow_ipc: column count does not match schema");
+  }
+  const std::size_t bitmap_size = (length + 7) / 8;
+  std::vector<FieldNode> nodes;
+  std::vector<BufferSpec> buffers;
+  std::int64_t body = 0;
+  for (std::size_t f = 0; f < columns.size(); ++f) {
+    const WriteColumn& column = columns[f];
+    if (!column.validity.empty() && column.validity.size() != bitmap_size) {
+      throw std::runtime_error("arrow_ipc: validity bitmap has the wrong size");
+    }
+    if (!column.values && length > 0) {
+      throw std::runtime_error("arrow_ipc: column values pointer is null");
+    }
+    nodes.push_back({static_cast<std::int64_t>(length), static_cast<std::int64_t>(column.null_count)});
+    const std::size_t validity_size = column.validity.size();
+    buffers.push_back({body, static_cast<std::int64_t>(validity_size)});
+    body += static_cast<std::int64_t>(padded8(validity_size));
+    const std::size_t values_size = length * physical_width(state_->fields[f].type);
+    buffers.push_back({body, static_cast<std::int64_t>(values_size)});
+    body += static_cast<std::int64_t>(padded8(values_size));
+  }
+
+  FlatBuilder fb;
+  const FlatBuilder::Offset batch =
+      build_record_batch(fb, static_cast<std::int64_t>(length), nodes, buffers);
+  Block block = state_->write_metadata(build_message(fb, kHeaderRecordBatch, batch, body), body);
+  for (std::size_t f = 0; f < columns.size(); ++f) {
+    const WriteColumn& column = columns[f];
+    state_->write_bytes(column.validity.data(), column.validity.size());
+    state_->write_padding(padded8(column.validity.size()) - column.validity.size());
+    const std::size_t values_size = length * physical_width(state_->fields[f].type);
+    state_->write_bytes(column.values, values_size);
+    state_->write_padding(padded8(values_size) - values_size);
+  }
+  state_->batches.push_back(block);
+}
+
+void FileWriter::close() {
+  if (state_->closed) return;
+  state_->closed = true;
+  const std::uint32_t end_of_stream[2] = {kContinuation, 0};
+  state_->write_bytes(end_of_stream, sizeof(end_of_stream));
+
+  FlatBuilder fb;
+  const FlatBuilder::Offset schema = build_schema(fb, state_->fields);
+  const FlatBuilder::Offset dictionaries =
+      fb.create_struct_vector(state_->dictionaries.data(), state_->dictionaries.size(), sizeof(Block));
+  const FlatBuilder::Offset batches =
+      fb.create_struct_vector(state_->batches.data(), state_->batches.size(), sizeof(Block));
+  fb.start_table();
+  fb.add_scalar<std::int16_t>(0, kMetadataV5);
+  fb.add_offset(1, schema);
+  fb.add_offset(2, dictionaries);
+  fb.add_offset(3, batches);
+  const std::vector<std::uint8_t> footer = fb.finish(fb.end_table());
+  const std::int32_t footer_size = static_cast<std::int32_t>(footer.size());
+  state_->write_bytes(footer.data(), footer.size());
+  state_->write_bytes(&footer_size, 4);
+  state_->write_bytes(kMagic, kMagicSize);
+  state_->out.close();
+}
+
+// ---------------------------------------------------------------- reader --
+
+namespace {
+
+struct BatchLayout {
+  std::size_t length = 0;
+  std::size_t body = 0;  // absolute file offset of the body
+  std::size_t body_length = 0;
+  std::vector<FieldNode> nodes;
+  std::vector<BufferSpec> buffers;
+};
+
+struct ColumnRef {
+  const std::uint8_t* validity = nullptr;  // null when every value is valid
+  const std::uint8_t* values = nullptr;
+  const std::uint8_t* data = nullptr;      // utf8 bytes
+  std::size_t data_size = 0;
+  std::size_t length = 0;
+};
+
+bool is_valid(const ColumnRef& column, std::size_t i) {
+  return !column.validity || ((column.validity[i >> 3] >> (i & 7)) & 1);
+}
+
+}  // namespace
+
+struct FileReader::State {
+  explicit State(const std::string& path) : file(path) {}
+
+  MappedFile file;
+  std::vector<FieldInfo> fields;
+  std::vector<std::size_t> first_buffer;  // index of each field's first buffer
+  std::vector<BatchLayout> batches;
+  std::map<std::int64_t, std::vector<std::string>> dictionaries;
+  std::string pandas_index;
+
+  Span span() const { return Span{file.data(), file.size()}; }
+
+  // Returns the message table and the absolute body offset of a footer block.
+  Table message_at(const Block& block, std::size_t& body) const {
+    if (block.offset < 0 || block.metadata_length < 8 ||
+        static_cast<std::size_t>(block.offset) + static_cast<std::size_t>(block.metadata_length) >
+            file.size()) {
+      throw std::runtime_error("arrow_ipc: block points outside the file");
+    }
+    std::size_t pos = static_cast<std::size_t>(block.offset);
+    std::uint32_t length = span().read<std::uint32_t>(pos);
+    pos += 4;
+    if (length == kContinuation) {
+      length = span().read<std::uint32_t>(pos);
+      pos += 4;
+    }
+    const std::size_t end = static_cast<std::size_t>(block.offset) +
+                            static_cast<std::size_t>(block.metadata_length);
+    if (pos + length > end) {
+      throw std::runtime_error("arrow_ipc: message metadata overruns its block");
+    }
+    body = end;
+    if (block.body_length < 0 || body + static_cast<std::size_t>(block.body_length) > file.size()) {
+      throw std::runtime_error("arrow_ipc: message body overruns the file");
+    }
+    return Table::root(Span{file.data() + pos, length});
+  }
+
+  BatchLayout read_batch(const Table& batch, std::size_t body, std::size_t body_length) const {
+    if (batch.has(3)) {
+      throw std::runtime_error("arrow_ipc: compressed record batches are not supported");
+    }
+    BatchLayout layout;
+    layout.length = static_cast<std::size_t>(batch.scalar<std::int64_t>(0, 0));
+    layout.body = body;
+    layout.body_length = body_length;
+    const Vector nodes = batch.vector(1);
+    const Vector buffers = batch.vector(2);
+    for (std::size_t i = 0; i < nodes.count; ++i) {
+      FieldNode node{batch.span().read<std::int64_t>(nodes.pos + 16 * i),
+                     batch.span().read<std::int64_t>(nodes.pos + 16 * i + 8)};
+      if (node.length < 0 || static_cast<std::size_t>(node.length) != layout.length ||
+          node.null_count < 0 || node.null_count > node.length) {
+        throw std::runtime_error("arrow_ipc: field node does not match the batch length");
+      }
+      layout.nodes.push_back(node);
+    }
+    for (std::size_t i = 0; i < buffers.count; ++i) {
+      BufferSpec buffer{batch.span().read<std::int64_t>(buffers.pos + 16 * i),
+                        batch.span().read<std::int64_t>(buffers.pos + 16 * i + 8)};
+      if (buffer.offset < 0 || buffer.length < 0 ||
+          static_cast<std::size_t>(buffer.offset) + static_cast<std::size_t>(buffer.length) >
+              body_length) {
+        throw std::runtime_error("arrow_ipc: buffer lies outside the message body");
+      }
+      layout.buffers.push_back(buffer);
+    }
+    return layout;
+  }
+
+  ColumnRef column(const BatchLayout& batch,
+                   std::size_t node,
+                   std::size_t first,
+                   std::size_t value_width,
+                   bool has_data) const {
+    if (node >= batch.nodes.size() || first + (has_data ? 3 : 2) > batch.buffers.size()) {
+      throw std::runtime_error("arrow_ipc: record batch has fewer columns than the schema");
+    }
+    ColumnRef out;
+    out.length = static_cast<std::size_t>(batch.nodes[node].length);
+    const BufferSpec& validity = batch.buffers[first];
+    if (batch.nodes[node].null_count > 0) {
+      if (static_cast<std::size_t>(validity.length) < (out.length + 7) / 8) {
+        throw std::runtime_error("arrow_ipc: validity bitmap is too short");
+      }
+      out.validity = file.data() + batch.body + static_cast<std::size_t>(validity.offset);
+    }
+    const BufferSpec& values = batch.buffers[first + 1];
+    if (static_cast<std::size_t>(values.length) < (out.length + (has_data ? 1 : 0)) * value_width) {
+      throw std::runtime_error("arrow_ipc: value buffer is too short");
+    }
+    out.values = file.data() + batch.body + static_cast<std::size_t>(values.offset);
+    if (has_data) {
+      const BufferSpec& data = batch.buffers[first + 2];
+      out.data = file.data() + batch.body + static_cast<std::size_t>(data.offset);
+      out.data_size = static_cast<std::size_t>(data.length);
+    }
+    return out;
+  }
+
+  ColumnRef field_column(std::size_t batch, std::size_t field) const {
+    if (batch >= batches.size() || field >= fields.size()) {
+      throw std::runtime_error("arrow_ipc: batch or field out of range");
+    }
+    const FieldInfo& info = fields[field];
+    if (info.dictionary_encoded) {
+      return column(batches[batch], field, first_buffer[field],
+                    static_cast<std::size_t>(info.index_bit_width / 8), false);
+    }
+    const bool has_data = info.kind == TypeKind::utf8;
+    const std::size_t width = static_cast<std::size_t>(info.bit_width / 8);
+    return column(batches[batch], field, first_buffer[field], width, has_data);
+  }
+};
+
+namespace {
+
+long long read_integer(const std::uint8_t* values, std::size_t i, int bit_width, bool is_signed) {
+  switch (bit_width) {
+    case 8: {
+      std::uint8_t v;
+      std::memcpy(&v, values + i, 1);
+      return is_signed ? static_cast<long long>(static_cast<std::int8_t>(v)) : static_cast<long long>(v);
+    }
+    case 16: {
+      std::uint16_t v;
+      std::memcpy(&v, values + 2 * i, 2);
+      return is_signed ? static_cast<long long>(static_cast<std::int16_t>(v)) : static_cast<long long>(v);
+    }
+    case 32: {
+      std::uint32_t v;
+      std::memcpy(&v, values + 4 * i, 4);
+      return is_signed ? static_cast<long long>(static_cast<std::int32_t>(v)) : static_cast<long long>(v);
+    }
+    default: {
+      std::int64_t v;
+      std::memcpy(&v, values + 8 * i, 8);
+      return static_cast<long long>(v);
+    }
+  }
+}
+
+// uint64 values above LLONG_MAX do not fit read_integer's result; callers
+// read them through this instead.
+std::uint64_t read_uint64(const std::uint8_t* values, std::size_t i) {
+  std::uint64_t v;
+  std::memcpy(&v, values + 8 * i, 8);
+  return v;
+}
+
+long long floor_div(long long value, long long divisor) {
+  long long q = value / divisor;
+  if ((value % divisor != 0) && ((value < 0) != (divisor < 0))) --q;
+  return q;
+}
+
+FieldInfo parse_field(const Table& field) {
+  FieldInfo info;
+  info.name = field.string(0);
+  if (field.vector(5).count > 0) {
+    throw std::runtime_error("arrow_ipc: nested field types are not supported");
+  }
+  const std::uint8_t tag = field.scalar<std::uint8_t>(2, 0);
+  const Table type = field.table(3);
+  switch (tag) {
+    case kTypeInt:
+      info.kind = TypeKind::integer;
+      info.bit_width = type.scalar<std::int32_t>(0, 0);
+      info.is_signed = type.scalar<std::uint8_t>(1, 0) != 0;
+      if (info.bit_width != 8 && info.bit_width != 16 && info.bit_width != 32 && info.bit_width != 64) {
+        throw std::runtime_error("arrow_ipc: unsupported integer width");
+      }
+      break;
+    case kTypeFloatingPoint: {
+      info.kind = TypeKind::floating;
+      const std::int16_t precision = type.scalar<std::int16_t>(0, 0);
+      if (precision == 1) {
+        info.bit_width = 32;
+      } else if (precision == 2) {
+        info.bit_width = 64;
+      } else {
+        throw std::runtime_error("arrow_ipc: half-precision floats are not supported");
+      }
+      break;
+    }
+    case kTypeUtf8:
+      info.kind = TypeKind::utf8;
+      info.bit_width = 32;
+      break;
+    case kTypeLargeUtf8:
+      info.kind = TypeKind::utf8;
+      info.bit_width = 64;
+      break;
+    case kTypeDate:
+      info.kind = TypeKind::date;
+      info.unit = type.scalar<std::int16_t>(0, 1);
+      info.bit_width = info.unit == 0 ? 32 : 64;
+      break;
+    case kTypeTimestamp:
+      info.kind = TypeKind::timestamp;
+      info.unit = type.scalar<std::int16_t>(0, 0);
+      info.bit_width = 64;
+      break;
+    default:
+      throw std::runtime_error("arrow_ipc: unsupported field type in '" + info.name + "'");
+  }
+  if (field.has(4)) {
+    const Table dictionary = field.table(4);
+    info.dictionary_encoded = true;
+    info.dictionary_id = dictionary.scalar<std::int64_t>(0, 0);
+    if (dictionary.has(1)) {
+      const Table index_type = dictionary.table(1);
+      info.index_bit_width = index_type.scalar<std::int32_t>(0, 32);
+      info.index_is_signed = index_type.scalar<std::uint8_t>(1, 0) != 0;
+    }
+    const int width = info.index_bit_width;
+    if ((width != 8 && width != 16 && width != 32 && width != 64) ||
+        (width == 64 && !info.index_is_signed)) {
+      throw std::runtime_error("arrow_ipc: unsupported dictionary index width");
+    }
+    if (info.kind != TypeKind::utf8) {
+      throw std::runtime_error("arrow_ipc: only utf8 dictionaries are supported");
+    }
+  }
+  return info;
+}
+
+std::string utf8_at(const ColumnRef& column, std::size_t i, int offset_width) {
+  long long begin = read_integer(column.values, i, offset_width, true);
+  long long end = read_integer(column.values, i + 1, offset_width, true);
+  if (begin < 0 || end < begin || static_cast<std::size_t>(end) > column.data_size) {
+    throw std::runtime_error("arrow_ipc: corrupt string offsets");
+  }
+  return std::string(reinterpret_cast<const char*>(column.data) + begin,
+                     static_cast<std::size_t>(end - begin));
+}
+
+}  // namespace
+
+FileReader::FileReader(const std::string& path) : state_(new State(path)) {
+  require_little_endian();
+  const Span file = state_->span();
+  if (file.size < 2 * kMagicSize + 6 || std::memcmp(file.data, kMagic, kMagicSize) != 0 ||
+      std::memcmp(file.data + file.size - kMagicSize, kMagic, kMagicSize) != 0) {
+    throw std::runtime_error("arrow_ipc: not an Arrow IPC file");
+  }
+  const std::int32_t footer_size = file.read<std::int32_t>(file.size - kMagicSize - 4);
+  if (footer_size <= 0 || static_cast<std::size_t>(footer_size) > file.size - kMagicSize - 4 - 8) {
+    throw std::runtime_error("arrow_ipc: corrupt footer length");
+  }
+  const std::size_t footer_pos = file.size - kMagicSize - 4 - static_cast<std::size_t>(footer_size);
+  const Table footer = Table::root(Span{file.data + footer_pos, static_cast<std::size_t>(footer_size)});
+
+  const Table schema = footer.table(1);
+  if (schema.scalar<std::int16_t>(0, 0) != 0) {
+    throw std::runtime_error("arrow_ipc: big-endian files are not supported");
+  }
+  const Vector field_vector = schema.vector(1);
+  std::size_t buffer_index = 0;
+  for (std::size_t i = 0; i < field_vector.count; ++i) {
+    state_->fields.push_back(parse_field(schema.table_at(field_vector, i)));
+    state_->first_buffer.push_back(buffer_index);
+    const FieldInfo& info = state_->fields.back();
+    buffer_index += (info.kind == TypeKind::utf8 && !info.dictionary_encoded) ? 3 : 2;
+  }
+  const Vector metadata = schema.vector(2);
+  for (std::size_t i = 0; i < metadata.count; ++i) {
+    const Table entry = schema.table_at(metadata, i);
+    if (entry.string(0) == "pandas") {
+      state_->pandas_index = pandas_index_from_metadata(entry.string(1));
+    }
+  }
+
+  auto read_blocks = [&](int slot) {
+    std::vector<Block> blocks;
+    const Vector vec = footer.vector(slot);
+    for (std::size_t i = 0; i < vec.count; ++i) {
+      const std::size_t pos = vec.pos + 24 * i;
+      Block block{};
+      block.offset = footer.span().read<std::int64_t>(pos);
+      block.metadata_length = footer.span().read<std::int32_t>(pos + 8);
+      block.body_length = footer.span().read<std::int64_t>(pos + 16);
+      blocks.push_back(block);
+    }
+    return blocks;
+  };
+
+  for (const Block& block : read_blocks(2)) {
+    std::size_t body = 0;
+    const Table message = state_->message_at(block, body);
+    if (message.scalar<std::uint8_t>(1, 0) != kHeaderDictionaryBatch) {
+      throw std::runtime_error("arrow_ipc: dictionary block does not hold a dictionary batch");
+    }
+    const Table dictionary = message.table(2);
+    const std::int64_t id = dictionary.scalar<std::int64_t>(0, 0);
+    const BatchLayout layout = state_->read_batch(dictionary.table(1), body,
+                                                  static_cast<std::size_t>(block.body_length));
+    int offset_width = 32;
+    for (const FieldInfo& info : state_->fields) {
+      if (info.dictionary_encoded && info.dictionary_id == id) offset_width = info.bit_width;
+    }
+    const ColumnRef column = state_->column(layout, 0, 0, static_cast<std::size_t>(offset_width / 8), true);
+    std::vector<std::string>& values = state_->dictionaries[id];
+    if (dictionary.scalar<std::uint8_t>(2, 0) == 0) values.clear();
+    for (std::size_t i = 0; i < column.length; ++i) {
+      values.push_back(is_valid(column, i) ? utf8_at(column, i, offset_width) : std::string());
+    }
+  }
+
+  for (const Block& block : read_blocks(3)) {
+    std::size_t body = 0;
+    const Table message = state_->message_at(block, body);
+    if (message.scalar<std::uint8_t>(1, 0) != kHeaderRecordBatch) {
+      throw std::runtime_error("arrow_ipc: record batch block does not hold a record batch");
+    }
+    state_->batches.push_back(
+        state_->read_batch(message.table(2), body, static_cast<std::size_t>(block.body_length)));
+    // Check every buffer against its field now so reads never touch bytes
+    // outside the mapping.
+    for (std::size_t f = 0; f < state_->fields.size(); ++f) {
+      state_->field_column(state_->batches.size() - 1, f);
+    }
+  }
+}
+
+FileReader::~FileReader() = default;
+
+const std::vector<FieldInfo>& FileReader::fields() const { return state_->fields; }
+
+std::size_t FileReader::batch_count() const { return state_->batches.size(); }
+
+std::size_t FileReader::batch_length(std::size_t batch) const {
+  if (batch >= state_->batches.size()) {
+    throw std::runtime_error("arrow_ipc: batch out of range");
+  }
+  return state_->batches[batch].length;
+}
+
+const std::string& FileReader::pandas_index_column() const { return state_->pandas_index; }
+
+std::vector<double> FileReader::read_doubles(std::size_t batch, std::size_t field) const {
+  const ColumnRef column = state_->field_column(batch, field);
+  const FieldInfo& info = state_->fields[field];
+  if (info.dictionary_encoded || info.kind == TypeKind::utf8) {
+    throw std::runtime_error("arrow_ipc: field '" + info.name + "' is not numeric");
+  }
+  std::vector<double> out(column.length);
+  for (std::size_t i = 0; i < column.length; ++i) {
+    if (!is_valid(column, i)) {
+      out[i] = std::numeric_limits<double>::quiet_NaN();
+    } else if (info.kind == TypeKind::floating && info.bit_width == 64) {
+      std::memcpy(&out[i], column.values + 8 * i, 8);
+    } else if (info.kind == TypeKind::floating) {
+      float v;
+      std::memcpy(&v, column.values + 4 * i, 4);
+      out[i] = static_cast<double>(v);
+    } else if (info.bit_width == 64 && !info.is_signed) {
+      out[i] = static_cast<double>(read_uint64(column.values, i));
+    } else {
+      out[i] = static_cast<double>(read_integer(column.values, i, info.bit_width, info.is_signed));
+    }
+  }
+  return out;
+}
+
+std::vector<long long> FileReader::read_integers(std::size_t batch, std::size_t field) const {
+  const ColumnRef column = state_->field_column(batch, field);
+  const FieldInfo& info = state_->fields[field];
+  if (info.kind != TypeKind::integer || info.dictionary_encoded) {
+    throw std::runtime_error("arrow_ipc: field '" + info.name + "' is not an integer field");
+  }
+  std::vector<long long> out(column.length);
+  for (std::size_t i = 0; i < column.length; ++i) {
+    if (!is_valid(column, i)) {
+      throw std::runtime_error("arrow_ipc: null value in integer field '" + info.name + "'");
+    }
+    if (info.bit_width == 64 && !info.is_signed &&
+        read_uint64(column.values, i) > static_cast<std::uint64_t>(std::numeric_limits<long long>::max())) {
+      throw std::runtime_error("arrow_ipc: uint64 value in field '" + info.name +
+                               "' exceeds the signed 64-bit range");
+    }
+    out[i] = read_integer(column.values, i, info.bit_width, info.is_signed);
+  }
+  return out;
+}
+
+std::vector<long long> FileReader::read_epoch_seconds(std::size_t batch, std::size_t field) const {
+  const ColumnRef column = state_->field_column(batch, field);
+  const FieldInfo& info = state_->fields[field];
+  long long multiplier = 1;
+  long long divisor = 1;
+  if (info.kind == TypeKind::date) {
+    if (info.unit == 0) {
+      multiplier = 86400;
+    } else {
+      divisor = 1000;
+    }
+  } else if (info.kind == TypeKind::timestamp) {
+    static const long long divisors[] = {1, 1000, 1000000, 1000000000};
+    divisor = divisors[std::min(std::max(info.unit, 0), 3)];
+  } else {
+    throw std::runtime_error("arrow_ipc: field '" + info.name + "' is not a date or timestamp");
+  }
+  std::vector<long long> out(column.length);
+  for (std::size_t i = 0; i < column.length; ++i) {
+    if (!is_valid(column, i)) {
+      throw std::runtime_error("arrow_ipc: null value in time field '" + info.name + "'");
+    }
+    const long long raw = read_integer(column.values, i, info.bit_width, true);
+    out[i] = floor_div(raw, divisor) * multiplier;
+  }
+  return out;
+}
+
+std::vector<std::string> FileReader::read_strings(std::size_t batch, std::size_t field) const {
+  const ColumnRef column = state_->field_column(batch, field);
+  const FieldInfo& info = state_->fields[field];
+  if (info.kind != TypeKind::utf8) {
+    throw std::runtime_error("arrow_ipc: field '" + info.name + "' is not a string field");
+  }
+  std::vector<std::string> out(column.length);
+  const std::vector<std::string>* dictionary = nullptr;
+  if (info.dictionary_encoded) {
+    auto it = state_->dictionaries.find(info.dictionary_id);
+    if (it == state_->dictionaries.end()) {
+      throw std::runtime_error("arrow_ipc: missing dictionary for field '" + info.name + "'");
+    }
+    dictionary = &it->second;
+  }
+  for (std::size_t i = 0; i < column.length; ++i) {
+    if (!is_valid(column, i)) {
+      throw std::runtime_error("arrow_ipc: null value in string field '" + info.name + "'");
+    }
+    if (dictionary) {
+      const long long code = read_integer(column.values, i, info.index_bit_width, info.index_is_signed);
+      if (code < 0 || static_cast<std::size_t>(code) >= dictionary->size()) {
+        throw std::runtime_error("arrow_ipc: dictionary index out of range");
+      }
+      out[i] = (*dictionary)[static_cast<std::size_t>(code)];
+    } else {
+      out[i] = utf8_at(column, i, info.bit_width);
+    }
+  }
+  return out;
+}
+
+}  // namespace arrow_ipc
+}  // namespace df
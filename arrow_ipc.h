@@ -0,0 +1,111 @@
+#ifndef DATAFRAME_ARROW_IPC_H
+#define DATAFRAME_ARROW_IPC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace df {
+namespace arrow_ipc {
+
+// Self-contained reader and writer for the Arrow IPC file format (Feather v2):
+// "ARROW1" magic, a flatbuffer Schema message, dictionary and record batch
+// messages with 8-byte aligned bodies, and a flatbuffer Footer indexing them.
+// Only uncompressed little-endian files are supported. DataFrame's
+// to_arrow_ipc_file / from_arrow_ipc_file map the index to the first field
+// (or the pandas index column when the schema carries pandas metadata) and
+// every other field to a double column.
+
+// Field types the writer can emit.
+enum class ColumnType {
+  float64,            // double values, NaN written as null
+  int64,              // signed 64-bit integers
+  date32,             // days since 1970-01-01
+  timestamp_seconds,  // seconds since 1970-01-01, no time zone
+  dictionary_utf8     // int32 indices into a utf8 dictionary
+};
+
+struct WriteField {
+  std::string name;
+  ColumnType type = ColumnType::float64;
+  std::vector<std::string> dictionary;  // dictionary_utf8 only
+};
+
+// One column of a record batch: values points at length elements of the
+// field's physical type (double, int64_t, or int32_t for date32 and
+// dictionary indices). validity is either empty (no nulls) or a bitmap of
+// (length + 7) / 8 bytes, least significant bit first.
+struct WriteColumn {
+  const void* values = nullptr;
+  std::vector<std::uint8_t> validity;
+  std::size_t null_count = 0;
+};
+
+class FileWriter {
+ public:
+  FileWriter(const std::string& path, std::vector<WriteField> fields);
+  ~FileWriter();
+
+  FileWriter(const FileWriter&) = delete;
+  FileWriter& operator=(const FileWriter&) = delete;
+
+  void write_batch(std::size_t length, const std::vector<WriteColumn>& columns);
+  // Writes the end-of-stream marker and footer; called by the destructor if needed.
+  void close();
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+// Logical type of a field as found in a file.
+enum class TypeKind { integer, floating, date, timestamp, utf8 };
+
+struct FieldInfo {
+  std::string name;
+  TypeKind kind = TypeKind::floating;
+  int bit_width = 64;        // integer and floating fields
+  bool is_signed = true;     // integer fields
+  int unit = 0;              // date: 0 day, 1 ms; timestamp: 0 s, 1 ms, 2 us, 3 ns
+  bool dictionary_encoded = false;
+  std::int64_t dictionary_id = 0;
+  int index_bit_width = 32;  // dictionary indices
+  bool index_is_signed = true;
+};
+
+// Memory-maps an IPC file and decodes values straight from the mapping; no
+// copy of the file is made.
+class FileReader {
+ public:
+  explicit FileReader(const std::string& path);
+  ~FileReader();
+
+  FileReader(const FileReader&) = delete;
+  FileReader& operator=(const FileReader&) = delete;
+
+  const std::vector<FieldInfo>& fields() const;
+  std::size_t batch_count() const;
+  std::size_t batch_length(std::size_t batch) const;
+  // Name of the first pandas index column from the schema metadata, or "".
+  const std::string& pandas_index_column() const;
+
+  // Numeric field as doubles; nulls become NaN.
+  std::vector<double> read_doubles(std::size_t batch, std::size_t field) const;
+  // Integer field values; throws on nulls and on uint64 values above LLONG_MAX.
+  std::vector<long long> read_integers(std::size_t batch, std::size_t field) const;
+  // Date or timestamp field as whole seconds since the epoch (rounded down); throws on nulls.
+  std::vector<long long> read_epoch_seconds(std::size_t batch, std::size_t field) const;
+  // Utf8 or dictionary-encoded utf8 field; throws on nulls.
+  std::vector<std::string> read_strings(std::size_t batch, std::size_t field) const;
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace arrow_ipc
+}  // namespace df
+
+#endif
@@ -0,0 +1,492 @@
+#include "column_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace df {
+namespace codec {
+
+namespace {
+
+int leading_zeros(std::uint64_t x) {
+#if defined(_MSC_VER)
+  unsigned long index = 0;
+  return _BitScanReverse64(&index, x) ? 63 - static_cast<int>(index) : 64;
+#else
+  return x ? __builtin_clzll(x) : 64;
+#endif
+}
+
+int trailing_zeros(std::uint64_t x) {
+#if defined(_MSC_VER)
+  unsigned long index = 0;
+  return _BitScanForward64(&index, x) ? static_cast<int>(index) : 64;
+#else
+  return x ? __builtin_ctzll(x) : 64;
+#endif
+}
+
+std::uint64_t double_bits(double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+double bits_double(std::uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+  return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+  return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// Differences are taken modulo 2^64 so extreme values never overflow.
+std::int64_t wrapping_sub(std::int64_t a, std::int64_t b) {
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b));
+}
+
+std::int64_t wrapping_add(std::int64_t a, std::int64_t b) {
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+}
+
+void put_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<std::uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<std::uint8_t>(value));
+}
+
+void put_u64(std::vector<std::uint8_t>& out, std::uint64_t value) {
+  std::uint8_t bytes[8];
+  std::memcpy(bytes, &value, 8);
+  out.insert(out.end(), bytes, bytes + 8);
+}
+
+class ByteReader {
+ public:
+  ByteReader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+  std::uint64_t varint() {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (pos_ >= size_) throw std::runtime_error("codec: truncated varint");
+      const std::uint8_t byte = data_[pos_++];
+      value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("codec: varint too long");
+  }
+
+  std::uint64_t u64() {
+    if (size_ - pos_ < 8) throw std::runtime_error("codec: truncated value");
+    std::uint64_t value;
+    std::memcpy(&value, data_ + pos_, 8);
+    pos_ += 8;
+    return value;
+  }
+
+  void expect_end() const {
+    if (pos_ != size_) throw std::runtime_error("codec: trailing bytes after payload");
+  }
+
+ private:
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_ = 0;
+};
+
+// MSB-first bit stream. Writes and reads take at most 32 bits at a time so
+// the accumulator never holds more than 39 live bits.
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<std::uint8_t>& out) : out_(out) {}
+
+  void write(std::uint64_t value, int bits) {
+    if (bits > 32) {
+      write(value >> 32, bits - 32);
+      bits = 32;
+    }
+    if (bits == 0) return;
+    acc_ = (acc_ << bits) | (value & ((std::uint64_t(1) << bits) - 1));
+    pending_ += bits;
+    while (pending_ >= 8) {
+      pending_ -= 8;
+      out_.push_back(static_cast<std::uint8_t>(acc_ >> pending_));
+    }
+  }
+
+  void flush() {
+    if (pending_ > 0) {
+      out_.push_back(static_cast<std::uint8_t>(acc_ << (8 - pending_)));
+      pending_ = 0;
+    }
+  }
+
+ private:
+  std::vector<std::uint8_t>& out_;
+  std::uint64_t acc_ = 0;
+  int pending_ = 0;
+};
+
+class BitReader {
+ public:
+  BitReader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+  std::uint64_t read(int bits) {
+    if (bits > 32) {
+      const std::uint64_t high = read(bits - 32);
+      return (high << 32) | read(32);
+    }
+    if (bits == 0) return 0;
+    while (pending_ < bits) {
+      if (pos_ >= size_) throw std::runtime_error("codec: truncated bit stream");
+      acc_ = (acc_ << 8) | data_[pos_++];
+      pending_ += 8;
+    }
+    pending_ -= bits;
+    return (acc_ >> pending_) & ((std::uint64_t(1) << bits) - 1);
+  }
+
+  bool bit() { return read(1) != 0; }
+
+  // Only the zero padding of the final byte may remain.
+  void expect_end() const {
+    if (pos_ != size_ || (acc_ & ((std::uint64_t(1) << pending_) - 1)) != 0) {
+      throw std::runtime_error("codec: trailing bits after payload");
+    }
+  }
+
+ private:
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_ = 0;
+  std::uint64_t acc_ = 0;
+  int pending_ = 0;
+};
+
+// Second differences go into prefix-coded buckets: '0' for zero, then
+// '10', '110', '1110', '11110' for 7, 9, 12 and 32 significant zigzag bits,
+// and '11111' followed by all 64 bits.
+void encode_delta_of_delta(const std::int64_t* values, std::size_t count, std::vector<std::uint8_t>& out) {
+  BitWriter writer(out);
+  std::int64_t previous = 0;
+  std::int64_t previous_delta = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i == 0) {
+      writer.write(static_cast<std::uint64_t>(values[0]), 64);
+      previous = values[0];
+      continue;
+    }
+    const std::int64_t delta = wrapping_sub(values[i], previous);
+    const std::uint64_t z = zigzag(wrapping_sub(delta, previous_delta));
+    if (z == 0) {
+      writer.write(0, 1);
+    } else if (z < (std::uint64_t(1) << 7)) {
+      writer.write(0x2, 2);
+      writer.write(z, 7);
+    } else if (z < (std::uint64_t(1) << 9)) {
+      writer.write(0x6, 3);
+      writer.write(z, 9);
+    } else if (z < (std::uint64_t(1) << 12)) {
+      writer.write(0xe, 4);
+      writer.write(z, 12);
+    } else if (z < (std::uint64_t(1) << 32)) {
+      writer.write(0x1e, 5);
+      writer.write(z, 32);
+    } else {
+      writer.write(0x1f, 5);
+      writer.write(z, 64);
+    }
+    previous = values[i];
+    previous_delta = delta;
+  }
+  writer.flush();
+}
+
+void decode_delta_of_delta(const std::uint8_t* data, std::size_t size, std::int64_t* out, std::size_t count) {
+  BitReader reader(data, size);
+  std::int64_t previous = 0;
+  std::int64_t previous_delta = 0;
+  static const int widths[] = {7, 9, 12, 32, 64};
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i == 0) {
+      previous = static_cast<std::int64_t>(reader.read(64));
+      out[0] = previous;
+      continue;
+    }
+    int ones = 0;
+    while (ones < 5 && reader.bit()) ++ones;
+    const std::uint64_t z = ones == 0 ? 0 : reader.read(widths[ones - 1]);
+    previous_delta = wrapping_add(previous_delta, unzigzag(z));
+    previous = wrapping_add(previous, previous_delta);
+    out[i] = previous;
+  }
+  reader.expect_end();
+}
+
+// Gorilla XOR: '0' when the value repeats, '10' + meaningful bits when the
+// XOR fits the previous leading/trailing-zero window, otherwise '11', 5 bits
+// of leading zeros, 6 bits of length (0 meaning 64) and the meaningful bits.
+void encode_xor(const double* values, std::size_t count, std::vector<std::uint8_t>& out) {
+  BitWriter writer(out);
+  std::uint64_t previous = 0;
+  int window_leading = -1;
+  int window_trailing = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint64_t bits = double_bits(values[i]);
+    if (i == 0) {
+      writer.write(bits, 64);
+      previous = bits;
+      continue;
+    }
+    const std::uint64_t x = bits ^ previous;
+    previous = bits;
+    if (x == 0) {
+      writer.write(0, 1);
+      continue;
+    }
+    const int leading = std::min(leading_zeros(x), 31);
+    const int trailing = trailing_zeros(x);
+    if (window_leading >= 0 && leading >= window_leading && trailing >= window_trailing) {
+      writer.write(0x2, 2);
+      writer.write(x >> window_trailing, 64 - window_leading - window_trailing);
+    } else {
+      const int significant = 64 - leading - trailing;
+      writer.write(0x3, 2);
+      writer.write(static_cast<std::uint64_t>(leading), 5);
+      writer.write(static_cast<std::uint64_t>(significant & 63), 6);
+      writer.write(x >> trailing, significant);
+      window_leading = leading;
+      window_trailing = trailing;
+    }
+  }
+  writer.flush();
+}
+
+void decode_xor(const std::uint8_t* data, std::size_t size, double* out, std::size_t count) {
+  BitReader reader(data, size);
+  std::uint64_t previous = 0;
+  int window_leading = -1;
+  int window_trailing = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i == 0) {
+      previous = reader.read(64);
+      out[0] = bits_double(previous);
+      continue;
+    }
+    if (reader.bit()) {
+      if (reader.bit()) {
+        window_leading = static_cast<int>(reader.read(5));
+        int significant = static_cast<int>(reader.read(6));
+        if (significant == 0) significant = 64;
+        window_trailing = 64 - window_leading - significant;
+        if (window_trailing < 0) throw std::runtime_error("codec: corrupt xor window");
+      } else if (window_leading < 0) {
+        throw std::runtime_error("codec: xor window used before it was set");
+      }
+      const int significant = 64 - window_leading - window_trailing;
+      previous ^= reader.read(significant) << window_trailing;
+    }
+    out[i] = bits_double(previous);
+  }
+  reader.expect_end();
+}
+
+void encode_run_length(const double* values, std::size_t count, std::vector<std::uint8_t>& out) {
+  std::size_t i = 0;
+  while (i < count) {
+    const std::uint64_t bits = double_bits(values[i]);
+    std::size_t run = 1;
+    while (i + run < count && double_bits(values[i + run]) == bits) ++run;
+    put_varint(out, run);
+    put_u64(out, bits);
+    i += run;
+  }
+}
+
+void decode_run_length(const std::uint8_t* data, std::size_t size, double* out, std::size_t count) {
+  ByteReader reader(data, size);
+  std::size_t filled = 0;
+  while (filled < count) {
+    const std::uint64_t run = reader.varint();
+    if (run == 0 || run > count - filled) throw std::runtime_error("codec: corrupt run length");
+    const double value = bits_double(reader.u64());
+    std::fill(out + filled, out + filled + run, value);
+    filled += static_cast<std::size_t>(run);
+  }
+  reader.expect_end();
+}
+
+void check_raw_size(std::size_t size, std::size_t count) {
+  if (size / 8 != count || size % 8 != 0) {
+    throw std::runtime_error("codec: raw payload has the wrong length");
+  }
+}
+
+const std::size_t kFullSampleLimit = 4096;
+const std::size_t kSampleWindows = 8;
+const std::size_t kSampleWindow = 512;
+
+// Calls measure(begin, length) on the sampled stretches of a column and
+// returns the summed encoded size.
+template <typename Measure>
+std::size_t sampled_size(std::size_t count, Measure measure) {
+  if (count <= kFullSampleLimit) return measure(0, count);
+  std::size_t total = 0;
+  const std::size_t stride = (count - kSampleWindow) / (kSampleWindows - 1);
+  for (std::size_t w = 0; w < kSampleWindows; ++w) {
+    total += measure(w * stride, kSampleWindow);
+  }
+  return total;
+}
+
+Encoding pick(std::size_t raw_size, const std::vector<std::pair<Encoding, std::size_t>>& sizes) {
+  Encoding best = Encoding::raw;
+  std::size_t best_size = raw_size - raw_size / 16;
+  for (const auto& candidate : sizes) {
+    if (candidate.second < best_size) {
+      best = candidate.first;
+      best_size = candidate.second;
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+Encoding choose_integer_encoding(const std::int64_t* values, std::size_t count) {
+  if (count < 2) return Encoding::raw;
+  std::vector<std::uint8_t> scratch;
+  std::vector<std::pair<Encoding, std::size_t>> sizes;
+  for (Encoding encoding : {Encoding::delta, Encoding::delta_of_delta}) {
+    const std::size_t size = sampled_size(count, [&](std::size_t begin, std::size_t length) {
+      scratch.clear();
+      encode_integers(encoding, values + begin, length, scratch);
+      return scratch.size();
+    });
+    sizes.emplace_back(encoding, size);
+  }
+  return pick(sampled_size(count, [](std::size_t, std::size_t length) { return 8 * length; }), sizes);
+}
+
+Encoding choose_double_encoding(const double* values, std::size_t count) {
+  if (count < 2) return Encoding::raw;
+  std::vector<std::uint8_t> scratch;
+  std::vector<std::pair<Encoding, std::size_t>> sizes;
+  for (Encoding encoding : {Encoding::xor_float, Encoding::run_length}) {
+    const std::size_t size = sampled_size(count, [&](std::size_t begin, std::size_t length) {
+      scratch.clear();
+      encode_doubles(encoding, values + begin, length, scratch);
+      return scratch.size();
+    });
+    sizes.emplace_back(encoding, size);
+  }
+  return pick(sampled_size(count, [](std::size_t, std::size_t length) { return 8 * length; }), sizes);
+}
+
+void encode_integers(Encoding encoding,
+                     const std::int64_t* values,
+                     std::size_t count,
+                     std::vector<std::uint8_t>& out) {
+  switch (encoding) {
+    case Encoding::raw:
+      for (std::size_t i = 0; i < count; ++i) put_u64(out, static_cast<std::uint64_t>(values[i]));
+      return;
+    case Encoding::delta: {
+      std::int64_t previous = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        put_varint(out, zigzag(wrapping_sub(values[i], previous)));
+        previous = values[i];
+      }
+      return;
+    }
+    case Encoding::delta_of_delta:
+      encode_delta_of_delta(values, count, out);
+      return;
+    default:
+      throw std::runtime_error("codec: encoding does not apply to integers");
+  }
+}
+
+void decode_integers(Encoding encoding,
+                     const std::uint8_t* data,
+                     std::size_t size,
+                     std::int64_t* out,
+                     std::size_t count) {
+  switch (encoding) {
+    case Encoding::raw:
+      check_raw_size(size, count);
+      if (count > 0) std::memcpy(out, data, size);
+      return;
+    case Encoding::delta: {
+      ByteReader reader(data, size);
+      std::int64_t previous = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        previous = wrapping_add(previous, unzigzag(reader.varint()));
+        out[i] = previous;
+      }
+      reader.expect_end();
+      return;
+    }
+    case Encoding::delta_of_delta:
+      decode_delta_of_delta(data, size, out, count);
+      return;
+    default:
+      throw std::runtime_error("codec: unknown integer encoding");
+  }
+}
+
+void encode_doubles(Encoding encoding,
+                    const double* values,
+                    std::size_t count,
+                    std::vector<std::uint8_t>& out) {
+  switch (encoding) {
+    case Encoding::raw:
+      for (std::size_t i = 0; i < count; ++i) put_u64(out, double_bits(values[i]));
+      return;
+    case Encoding::xor_float:
+      encode_xor(values, count, out);
+      return;
+    case Encoding::run_length:
+      encode_run_length(values, count, out);
+      return;
+    default:
+      throw std::runtime_error("codec: encoding does not apply to doubles");
+  }
+}
+
+void decode_doubles(Encoding encoding,
+                    const std::uint8_t* data,
+                    std::size_t size,
+                    double* out,
+                    std::size_t count) {
+  switch (encoding) {
+    case Encoding::raw:
+      check_raw_size(size, count);
+      if (count > 0) std::memcpy(out, data, size);
+      return;
+    case Encoding::xor_float:
+      decode_xor(data, size, out, count);
+      return;
+    case Encoding::run_length:
+      decode_run_length(data, size, out, count);
+      return;
+    default:
+      throw std::runtime_error("codec: unknown double encoding");
+  }
+}
+
+}  // namespace codec
+}  // namespace df
@@ -7,24 +7,62 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <exception>
 #include <fstream>
 #include <istream>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <random>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "arrow_ipc.h"
+#include "column_codec.h"
 #include "date_utils.h"
+#include "parallel.h"
 #include "stats.h"
 
 namespace df {
 
+// Row resampling scheme used by the bootstrap engine. moving_block draws
+// fixed-length runs of consecutive rows; stationary draws runs with geometric
+// lengths of mean block_length and wraps around the end of the frame.
+enum class BootstrapMethod { iid, moving_block, stationary };
+
+// Change computed by multi_lag_changes between a value and its lagged value.
+enum class ChangeKind { difference, proportional, log };
+
+// Target a covariance estimate is shrunk towards: the scaled identity of
+// Ledoit-Wolf (2004) or the constant-correlation matrix of Ledoit-Wolf (2003).
+enum class ShrinkageTarget { scaled_identity, constant_correlation };
+
+// Layout written by to_binary. none stores raw row-major doubles ("DFBIN1");
+// automatic stores each column (and a numeric index) on its own, encoded with
+// whichever codec in column_codec.h a sample of it compresses best ("DFBIN2").
+// from_binary reads both.
+enum class BinaryCompression { none, automatic };
+
+// Per-column reducer for resample_time. NaN values are ignored; a bucket with
+// no valid values yields NaN (count yields 0).
+enum class Aggregation { first, last, min, max, sum, mean, count };
+
+struct BootstrapOptions {
+  std::size_t replicates = 1000;
+  BootstrapMethod method = BootstrapMethod::iid;
+  std::size_t block_length = 1;
+  std::size_t sample_size = 0;  // 0 means one draw per source row
+  std::uint64_t seed = 0;       // 0 means seed from std::random_device
+};
+
 namespace detail {
 
 inline std::string trim(const std::string& s) {
@@ -70,6 +108,36 @@ T parse_token(const std::string& token) {
 template <typename>
 struct dependent_false : std::false_type {};
 
+// Lagged-change formulas shared by diff, pct_change, log_change and
+// multi_lag_changes. NaN in either operand gives NaN; a base that leaves the
+// change undefined throws, naming the calling method.
+struct DifferenceChange {
+  double operator()(double curr, double prev) const { return curr - prev; }
+};
+
+struct ProportionalChange {
+  const char* caller;
+  double operator()(double curr, double prev) const {
+    if (!(curr == curr) || !(prev == prev)) return std::numeric_limits<double>::quiet_NaN();
+    if (prev == 0.0) {
+      throw std::runtime_error(std::string("dataframe::") + caller + ": zero value encountered");
+    }
+    return (curr - prev) / prev;
+  }
+};
+
+struct LogChange {
+  const char* caller;
+  double operator()(double curr, double prev) const {
+    if (!(curr == curr) || !(prev == prev)) return std::numeric_limits<double>::quiet_NaN();
+    if (!(prev > 0.0) || !(curr > 0.0)) {
+      throw std::runtime_error(std::string("dataframe::") + caller +
+                               ": non-positive value encountered");
+    }
+    return std::log(curr) - std::log(prev);
+  }
+};
+
 template <typename T>
 void write_pod(std::ostream& os, const T& value) {
   os.write(reinterpret_cast<const char*>(&value), sizeof(T));
@@ -99,9 +167,13 @@ inline void write_string(std::ostream& os, const std::string& value) {
   }
 }
 
-inline std::string read_string(std::istream& is) {
+// max_length lets callers that know how many bytes remain reject a corrupt
+// length before allocating for it.
+inline std::string read_string(std::istream& is,
+                               std::uint64_t max_length = std::numeric_limits<std::uint64_t>::max()) {
   std::uint64_t length = read_pod<std::uint64_t>(is);
-  if (length > static_cast<std::uint64_t>(std::numeric_limits<std::size_t>::max())) {
+  if (length > max_length ||
+      length > static_cast<std::uint64_t>(std::numeric_limits<std::size_t>::max())) {
     throw std::runtime_error("dataframe::binary_read: string too large");
   }
   std::string value(static_cast<std::size_t>(length), '\0');
@@ -138,11 +210,12 @@ void write_index_value(std::ostream& os, const T& value) {
 }
 
 template <typename T>
-T read_index_value(std::istream& is) {
+T read_index_value(std::istream& is,
+                   std::uint64_t max_string_length = std::numeric_limits<std::uint64_t>::max()) {
   if constexpr (std::is_arithmetic_v<T>) {
     return read_pod<T>(is);
   } else if constexpr (std::is_same_v<T, std::string>) {
-    return read_string(is);
+    return read_string(is, max_string_length);
   } else if constexpr (std::is_same_v<T, Date>) {
     Date value;
     value.year = read_pod<int>(is);
@@ -202,18 +275,560 @@ inline double compute_median(std::vector<double> values) {
   return median;
 }
 
+// SplitMix64 finalizer; maps (seed, stream) counters to well-mixed 64-bit seeds
+// so every replicate or path gets an independent, reproducible RNG stream.
+inline std::uint64_t splitmix64(std::uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// Counter-based standard normal: the draw for (stream, counter) is a pure
+// function of its arguments (Box-Muller over two SplitMix64 outputs), so paths
+// can be simulated in any order or split across threads reproducibly.
+inline double counter_normal(std::uint64_t stream, std::uint64_t counter) {
+  const std::uint64_t h1 = splitmix64(stream + 2 * counter);
+  const std::uint64_t h2 = splitmix64(stream + 2 * counter + 1);
+  const double u1 = (static_cast<double>(h1 >> 11) + 0.5) * 0x1.0p-53;
+  const double u2 = static_cast<double>(h2 >> 11) * 0x1.0p-53;
+  const double two_pi = 6.283185307179586476925;
+  return std::sqrt(-2.0 * std::log(u1)) * std::cos(two_pi * u2);
+}
+
+inline std::uint64_t resolve_seed(std::uint64_t seed) {
+  if (seed != 0) return seed;
+  std::random_device rd;
+  return (static_cast<std::uint64_t>(rd()) << 32) ^ static_cast<std::uint64_t>(rd());
+}
+
+// Fills positions with sample_size row positions drawn from [0, row_count)
+// according to the bootstrap method.
+template <typename Rng>
+void draw_bootstrap_positions(std::size_t row_count,
+                              std::size_t sample_size,
+                              BootstrapMethod method,
+                              std::size_t block_length,
+                              Rng& rng,
+                              std::vector<std::size_t>& positions) {
+  positions.resize(sample_size);
+  if (sample_size == 0 || row_count == 0) return;
+  if (block_length == 0) block_length = 1;
+  if (block_length > row_count) block_length = row_count;
+
+  switch (method) {
+    case BootstrapMethod::iid: {
+      std::uniform_int_distribution<std::size_t> pick(0, row_count - 1);
+      for (std::size_t i = 0; i < sample_size; ++i) positions[i] = pick(rng);
+      break;
+    }
+    case BootstrapMethod::moving_block: {
+      std::uniform_int_distribution<std::size_t> start(0, row_count - block_length);
+      std::size_t i = 0;
+      while (i < sample_size) {
+        std::size_t pos = start(rng);
+        for (std::size_t j = 0; j < block_length && i < sample_size; ++j, ++i) {
+          positions[i] = pos + j;
+        }
+      }
+      break;
+    }
+    case BootstrapMethod::stationary: {
+      std::uniform_int_distribution<std::size_t> start(0, row_count - 1);
+      std::bernoulli_distribution restart(1.0 / static_cast<double>(block_length));
+      std::size_t pos = start(rng);
+      positions[0] = pos;
+      for (std::size_t i = 1; i < sample_size; ++i) {
+        pos = restart(rng) ? start(rng) : (pos + 1 == row_count ? 0 : pos + 1);
+        positions[i] = pos;
+      }
+      break;
+    }
+  }
+}
+
+// Linear-interpolated percentile (0..100) of an ascending, NaN-free vector.
+inline double sorted_percentile(const std::vector<double>& values, double percentile) {
+  if (values.empty()) return std::numeric_limits<double>::quiet_NaN();
+  if (percentile <= 0.0) return values.front();
+  if (percentile >= 100.0) return values.back();
+  double rank = (percentile / 100.0) * static_cast<double>(values.size() - 1);
+  std::size_t lower = static_cast<std::size_t>(std::floor(rank));
+  std::size_t upper = static_cast<std::size_t>(std::ceil(rank));
+  double fraction = rank - static_cast<double>(lower);
+  return values[lower] + fraction * (values[upper] - values[lower]);
+}
+
+// Maps a non-NaN double to an unsigned key whose unsigned order matches the
+// numeric order: flip every bit of negatives, flip only the sign of the rest.
+// -0.0 is folded into +0.0 so equal values keep their relative order.
+inline std::uint64_t orderable_key(double value, bool ascending) {
+  if (value == 0.0) value = 0.0;
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits = (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+  return ascending ? bits : ~bits;
+}
+
+// Positions of the k largest (or smallest) values among NaN-free candidates,
+// best first, ties kept in position order. nth_element partitions off the
+// winners in O(n) and only those k are sorted.
+inline std::vector<std::size_t> top_k_positions(
+    std::vector<std::pair<double, std::size_t>> candidates,
+    std::size_t k,
+    bool largest) {
+  auto better = [largest](const std::pair<double, std::size_t>& a,
+                          const std::pair<double, std::size_t>& b) {
+    if (a.first != b.first) return largest ? a.first > b.first : a.first < b.first;
+    return a.second < b.second;
+  };
+  k = std::min(k, candidates.size());
+  if (k < candidates.size()) {
+    std::nth_element(candidates.begin(),
+                     candidates.begin() + static_cast<std::ptrdiff_t>(k),
+                     candidates.end(),
+                     better);
+  }
+  std::sort(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(k), better);
+  std::vector<std::size_t> positions(k);
+  for (std::size_t i = 0; i < k; ++i) positions[i] = candidates[i].second;
+  return positions;
+}
+
+// Stable LSD radix sort of (key, payload) pairs on 11-bit digits. Each pass
+// histograms fixed chunks in parallel, turns the histograms into per-chunk
+// offsets and scatters the chunks in parallel; passes where every key shares
+// the same digit are skipped.
+inline void radix_sort_pairs(std::vector<std::uint64_t>& keys,
+                             std::vector<std::size_t>& payload) {
+  const std::size_t n = keys.size();
+  if (n < 2) return;
+  constexpr unsigned digit_bits = 11;
+  constexpr std::size_t bucket_count = std::size_t{1} << digit_bits;
+  constexpr std::uint64_t mask = bucket_count - 1;
+
+  std::size_t chunks = static_cast<std::size_t>(std::thread::hardware_concurrency());
+  if (chunks == 0) chunks = 1;
+  chunks = std::max<std::size_t>(1, std::min(chunks, n / 65536));
+  const std::size_t chunk_size = (n + chunks - 1) / chunks;
+
+  std::vector<std::uint64_t> key_buffer(n);
+  std::vector<std::size_t> payload_buffer(n);
+  std::vector<std::size_t> counts(chunks * bucket_count);
+
+  for (unsigned shift = 0; shift < 64; shift += digit_bits) {
+    std::fill(counts.begin(), counts.end(), 0);
+    parallel_for(chunks, [&](std::size_t chunk_begin, std::size_t chunk_end) {
+      for (std::size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+        std::size_t* hist = &counts[chunk * bucket_count];
+        const std::size_t end = std::min(n, (chunk + 1) * chunk_size);
+        for (std::size_t i = chunk * chunk_size; i < end; ++i) {
+          ++hist[(keys[i] >> shift) & mask];
+        }
+      }
+    });
+
+    bool trivial = false;
+    std::size_t running = 0;
+    for (std::size_t digit = 0; digit < bucket_count && !trivial; ++digit) {
+      std::size_t digit_total = 0;
+      for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        std::size_t& slot = counts[chunk * bucket_count + digit];
+        const std::size_t count = slot;
+        slot = running;
+        running += count;
+        digit_total += count;
+      }
+      trivial = (digit_total == n);
+    }
+    if (trivial) continue;
+
+    parallel_for(chunks, [&](std::size_t chunk_begin, std::size_t chunk_end) {
+      for (std::size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+        std::size_t* offsets = &counts[chunk * bucket_count];
+        const std::size_t end = std::min(n, (chunk + 1) * chunk_size);
+        for (std::size_t i = chunk * chunk_size; i < end; ++i) {
+          const std::size_t dest = offsets[(keys[i] >> shift) & mask]++;
+          key_buffer[dest] = keys[i];
+          payload_buffer[dest] = payload[i];
+        }
+      }
+    });
+    keys.swap(key_buffer);
+    payload.swap(payload_buffer);
+  }
+}
+
+// y[0..n) += a * x[0..n). Unrolled with all loads ahead of the stores so the
+// compiler can vectorize it without alias checks; each y[j] still receives a
+// single a * x[j] update, so results match the plain loop.
+inline void axpy(double a, const double* x, double* y, std::size_t n) {
+  std::size_t j = 0;
+  for (; j + 4 <= n; j += 4) {
+    const double x0 = x[j], x1 = x[j + 1], x2 = x[j + 2], x3 = x[j + 3];
+    const double y0 = y[j] + a * x0;
+    const double y1 = y[j + 1] + a * x1;
+    const double y2 = y[j + 2] + a * x2;
+    const double y3 = y[j + 3] + a * x3;
+    y[j] = y0;
+    y[j + 1] = y1;
+    y[j + 2] = y2;
+    y[j + 3] = y3;
+  }
+  for (; j < n; ++j) y[j] += a * x[j];
+}
+
+// Dot product of (x - shift) and y with four independent partial sums; shift
+// may be null.
+inline double shifted_dot(const double* x, const double* shift, const double* y, std::size_t n) {
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  std::size_t j = 0;
+  if (shift) {
+    for (; j + 4 <= n; j += 4) {
+      s0 += (x[j] - shift[j]) * y[j];
+      s1 += (x[j + 1] - shift[j + 1]) * y[j + 1];
+      s2 += (x[j + 2] - shift[j + 2]) * y[j + 2];
+      s3 += (x[j + 3] - shift[j + 3]) * y[j + 3];
+    }
+    for (; j < n; ++j) s0 += (x[j] - shift[j]) * y[j];
+  } else {
+    for (; j + 4 <= n; j += 4) {
+      s0 += x[j] * y[j];
+      s1 += x[j + 1] * y[j + 1];
+      s2 += x[j + 2] * y[j + 2];
+      s3 += x[j + 3] * y[j + 3];
+    }
+    for (; j < n; ++j) s0 += x[j] * y[j];
+  }
+  return (s0 + s1) + (s2 + s3);
+}
+
+// Tile edge (in output rows/columns) for the blocked matrix kernels; a
+// 128 x 128 tile of doubles is 128 KB and stays in L2 while rows stream by.
+constexpr std::size_t kMatrixTile = 128;
+
+// Most row bands transposed_product splits a product into; caps the memory
+// held in per-band partial results.
+constexpr std::size_t kMatrixMaxBands = 32;
+
+}  // namespace detail
+
+template <typename IndexT>
+class DataFrame;
+
+template <typename IndexT>
+class RollingOperator;
+
+template <typename IndexT>
+class EmaOperator;
+
+template <typename IndexT>
+class FrozenDataFrame;
+
+template <typename IndexT>
+struct OlsFit;
+
+template <typename IndexT>
+struct PcaResult;
+
+struct ShrunkCovariance;
+
+// Read-only rows x cols matrix over existing row-major storage. Row i starts at
+// its own pointer, so a view can cover a frame's rows (or any subset of them)
+// without copying. An optional per-column shift is subtracted on every read,
+// letting the kernels below work on centered data in place. The view does not
+// own the data; it must not outlive it.
+class MatrixView {
+ public:
+  MatrixView() = default;
+  MatrixView(const double* data, std::size_t rows, std::size_t cols, std::size_t row_stride = 0);
+  MatrixView(std::vector<const double*> row_pointers, std::size_t cols);
+
+  std::size_t rows() const { return rows_.size(); }
+  std::size_t cols() const { return cols_; }
+  const double* row(std::size_t i) const { return rows_[i]; }
+  const double* shift() const { return shift_; }
+  double operator()(std::size_t i, std::size_t j) const {
+    return shift_ ? rows_[i][j] - shift_[j] : rows_[i][j];
+  }
+
+  // Same rows, read as value - shift[j]; shift must hold cols() values.
+  MatrixView centered(const double* shift) const;
+
+ private:
+  std::vector<const double*> rows_;
+  std::size_t cols_ = 0;
+  const double* shift_ = nullptr;
+};
+
+// Dense row-major matrix returned by the kernels below.
+struct Matrix {
+  Matrix() = default;
+  Matrix(std::size_t row_count, std::size_t col_count, double fill = 0.0)
+      : rows(row_count), cols(col_count), values(row_count * col_count, fill) {}
+
+  double& operator()(std::size_t i, std::size_t j) { return values[i * cols + j]; }
+  double operator()(std::size_t i, std::size_t j) const { return values[i * cols + j]; }
+  double* row(std::size_t i) { return &values[i * cols]; }
+  const double* row(std::size_t i) const { return &values[i * cols]; }
+  MatrixView view() const { return MatrixView(values.data(), rows, cols); }
+
+  std::size_t rows = 0;
+  std::size_t cols = 0;
+  std::vector<double> values;
+};
+
+inline MatrixView::MatrixView(const double* data,
+                              std::size_t rows,
+                              std::size_t cols,
+                              std::size_t row_stride)
+    : rows_(rows), cols_(cols) {
+  if (row_stride == 0) row_stride = cols;
+  if (row_stride < cols) {
+    throw std::runtime_error("matrix_view: row_stride is too small");
+  }
+  if (!data && rows > 0 && cols > 0) {
+    throw std::runtime_error("matrix_view: data pointer is null");
+  }
+  for (std::size_t i = 0; i < rows; ++i) rows_[i] = data + i * row_stride;
+}
+
+inline MatrixView::MatrixView(std::vector<const double*> row_pointers, std::size_t cols)
+    : rows_(std::move(row_pointers)), cols_(cols) {}
+
+inline MatrixView MatrixView::centered(const double* shift) const {
+  MatrixView out = *this;
+  out.shift_ = shift;
+  return out;
+}
+
+namespace detail {
+
+// Shared body of gemm_tn and syrk: C[i][j] = sum_r A(r, i) * B(r, j), split into
+// kMatrixTile-square output tiles. Every tile streams its rows once and
+// accumulates with axpy, so each entry is summed in row order. With
+// upper_only, tiles and entries below the diagonal are skipped.
+//
+// Tiles are handed out across threads. When there are only a few tiles (any
+// k up to kMatrixTile is a single tile) and enough rows, the rows are split
+// into bands instead: each band is summed into a private partial result and
+// the partials are added to C in band order. The band split depends only on
+// the shapes, never on the thread count, so results are the same on every
+// machine; they can differ in the last bits from a plain row-order sum.
+inline void transposed_product(const MatrixView& a, const MatrixView& b, bool upper_only, Matrix& c) {
+  const std::size_t n = a.rows();
+  const std::size_t ka = a.cols();
+  const std::size_t kb = b.cols();
+  const std::size_t tile = kMatrixTile;
+  std::vector<std::pair<std::size_t, std::size_t>> tiles;
+  for (std::size_t i0 = 0; i0 < ka; i0 += tile) {
+    for (std::size_t j0 = upper_only ? i0 : 0; j0 < kb; j0 += tile) tiles.emplace_back(i0, j0);
+  }
+  auto accumulate = [&](std::size_t row_begin, std::size_t row_end,
+                        std::size_t tile_begin, std::size_t tile_end, Matrix& out) {
+    std::vector<double> left(tile), right(tile);
+    for (std::size_t t = tile_begin; t < tile_end; ++t) {
+      const std::size_t i0 = tiles[t].first;
+      const std::size_t j0 = tiles[t].second;
+      const std::size_t ti = std::min(tile, ka - i0);
+      const std::size_t tj = std::min(tile, kb - j0);
+      for (std::size_t r = row_begin; r < row_end; ++r) {
+        const double* xi = a.row(r) + i0;
+        const double* xj = b.row(r) + j0;
+        if (a.shift()) {
+          for (std::size_t i = 0; i < ti; ++i) left[i] = xi[i] - a.shift()[i0 + i];
+          xi = left.data();
+        }
+        if (b.shift()) {
+          for (std::size_t j = 0; j < tj; ++j) right[j] = xj[j] - b.shift()[j0 + j];
+          xj = right.data();
+        }
+        for (std::size_t i = 0; i < ti; ++i) {
+          const std::size_t skip = (upper_only && i0 == j0) ? i : 0;
+          axpy(xi[i], xj + skip, out.row(i0 + i) + j0 + skip, tj - skip);
+        }
+      }
+    }
+  };
+
+  // A band should carry about a million multiply-adds to pay for its thread
+  // and its partial matrix.
+  const std::size_t band_rows = std::max<std::size_t>(256, (std::size_t{1} << 20) / std::max<std::size_t>(1, ka * kb));
+  const std::size_t bands = std::min(kMatrixMaxBands, n / band_rows);
+  // Eight or more tiles keep the threads busy without bands.
+  if (tiles.size() >= 8 || bands < 2) {
+    parallel_for(tiles.size(), [&](std::size_t begin, std::size_t end) {
+      accumulate(0, n, begin, end, c);
+    });
+    return;
+  }
+
+  const std::size_t chunk = (n + bands - 1) / bands;
+  std::vector<Matrix> partials(bands - 1, Matrix(c.rows, c.cols));
+  parallel_for(bands, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t band = begin; band < end; ++band) {
+      accumulate(band * chunk, std::min(n, (band + 1) * chunk), 0, tiles.size(),
+                 band == 0 ? c : partials[band - 1]);
+    }
+  });
+  for (const Matrix& partial : partials) {
+    for (std::size_t i = 0; i < c.values.size(); ++i) c.values[i] += partial.values[i];
+  }
+}
+
 }  // namespace detail
+
+// C = A * B.
+inline Matrix gemm(const MatrixView& a, const MatrixView& b) {
+  if (a.cols() != b.rows()) {
+    throw std::runtime_error("gemm: inner dimensions do not match");
+  }
+  const std::size_t k = a.cols();
+  const std::size_t m = b.cols();
+  Matrix c(a.rows(), m);
+  const std::size_t depth_block = detail::kMatrixTile;
+  const std::size_t width_block = 2 * detail::kMatrixTile;
+  // Each thread owns a band of output rows; the p/j blocking keeps a
+  // depth_block x width_block panel of B hot while the band's rows reuse it.
+  detail::parallel_for(a.rows(), [&](std::size_t begin, std::size_t end) {
+    for (std::size_t p0 = 0; p0 < k; p0 += depth_block) {
+      const std::size_t p1 = std::min(k, p0 + depth_block);
+      for (std::size_t j0 = 0; j0 < m; j0 += width_block) {
+        const std::size_t tj = std::min(width_block, m - j0);
+        for (std::size_t i = begin; i < end; ++i) {
+          double* out = c.row(i) + j0;
+          for (std::size_t p = p0; p < p1; ++p) {
+            detail::axpy(a(i, p), b.row(p) + j0, out, tj);
+          }
+        }
+      }
+    }
+  }, 16);
+  if (b.shift()) {
+    // (A * (B - 1 s')) = A * B - (A * 1) s'; fold the shift of B in afterwards.
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+      double row_sum = 0.0;
+      for (std::size_t p = 0; p < k; ++p) row_sum += a(i, p);
+      for (std::size_t j = 0; j < m; ++j) c(i, j) -= row_sum * b.shift()[j];
+    }
+  }
+  return c;
+}
+
+// C = A' * B (A and B share their row count).
+inline Matrix gemm_tn(const MatrixView& a, const MatrixView& b) {
+  if (a.rows() != b.rows()) {
+    throw std::runtime_error("gemm_tn: row counts do not match");
+  }
+  Matrix c(a.cols(), b.cols());
+  detail::transposed_product(a, b, false, c);
+  return c;
+}
+
+// C = A' * A, computed on the upper triangle and mirrored.
+inline Matrix syrk(const MatrixView& a) {
+  Matrix c(a.cols(), a.cols());
+  detail::transposed_product(a, a, true, c);
+  for (std::size_t i = 0; i < c.rows; ++i) {
+    for (std::size_t j = 0; j < i; ++j) c(i, j) = c(j, i);
+  }
+  return c;
+}
+
+// y = A * x.
+inline std::vector<double> gemv(const MatrixView& a, const std::vector<double>& x) {
+  if (x.size() != a.cols()) {
+    throw std::runtime_error("gemv: vector length does not match column count");
+  }
+  std::vector<double> y(a.rows());
+  detail::parallel_for(a.rows(), [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      y[i] = detail::shifted_dot(a.row(i), a.shift(), x.data(), a.cols());
+    }
+  }, 1024);
+  return y;
+}
+
+// y = A' * x.
+inline std::vector<double> gemv_t(const MatrixView& a, const std::vector<double>& x) {
+  if (x.size() != a.rows()) {
+    throw std::runtime_error("gemv_t: vector length does not match row count");
+  }
+  const std::size_t m = a.cols();
+  std::vector<double> y(m, 0.0);
+  // Threads own bands of output columns and stream every row over their band.
+  detail::parallel_for(m, [&](std::size_t begin, std::size_t end) {
+    std::vector<double> centered;
+    for (std::size_t r = 0; r < a.rows(); ++r) {
+      const double* row = a.row(r) + begin;
+      if (a.shift()) {
+        centered.resize(end - begin);
+        for (std::size_t j = begin; j < end; ++j) centered[j - begin] = a.row(r)[j] - a.shift()[j];
+        row = centered.data();
+      }
+      detail::axpy(x[r], row, y.data() + begin, end - begin);
+    }
+  }, detail::kMatrixTile);
+  return y;
+}
+
+enum class RollingStatistic { mean, std, rms };
+
+// Exponentially weighted covariance of a fixed set of columns, updated one row
+// at a time in O(k^2) (upper triangle only). With demean the update is
+//   d = x - m;  m += alpha * d;  S = (1 - alpha) * (S + alpha * d d')
+// and without it the RiskMetrics form S = (1 - alpha) * S + alpha * x x'.
+// Rows containing NaN are skipped. The object keeps its state, so a live feed
+// can keep calling update() with new rows instead of recomputing history.
+// update(frame) works like RollingOperator::update: it folds in only the rows
+// past consumed(), so the growing live frame can be passed on every tick.
+// update(row) counts toward consumed() too, so the two can be mixed as long as
+// each row fed singly is the next row of the frame passed later.
+class EwmCovariance {
+ public:
+  EwmCovariance(const std::vector<std::string>& columns, double alpha, bool demean = true);
+
+  void update(const double* row);
+  void update(const std::vector<double>& row);
+  template <typename IndexT>
+  void update(const DataFrame<IndexT>& frame);
+
+  std::size_t count() const { return count_; }
+  std::size_t consumed() const { return consumed_; }
+  double alpha() const { return alpha_; }
+  const std::vector<std::string>& columns() const { return columns_; }
+  const std::vector<double>& mean() const { return mean_; }
+  double covariance(std::size_t i, std::size_t j) const;
+  DataFrame<std::string> covariance_matrix() const;
+  DataFrame<std::string> correlation_matrix() const;
+
+ private:
+  std::vector<std::string> columns_;
+  double alpha_;
+  bool demean_;
+  std::size_t count_ = 0;
+  std::size_t consumed_ = 0;
+  std::vector<double> mean_;
+  std::vector<double> cov_;
+  std::vector<double> diff_;
+
+  void fold(const double* row);
+};
 
 template <typename IndexT>
 class DataFrame {
  public:
   template <typename> friend class DataFrame;
+  friend class EwmCovariance;
+  friend class RollingOperator<IndexT>;
+  friend class EmaOperator<IndexT>;
   static DataFrame from_csv(std::istream& input, bool has_index);
   static DataFrame from_vectors(const std::vector<IndexT>& indices,
                                 const std::vector<std::string>& columns,
                                 const std::vector<std::vector<double>>& data);
   static DataFrame from_binary(std::istream& input);
   static DataFrame from_binary_file(const std::string& path);
+  static DataFrame from_arrow_ipc_file(const std::string& path);
   static DataFrame random_normal(std::size_t rows,
                                  const std::vector<std::string>& columns,
                                  double mean = 0.0,
@@ -225,6 +840,29 @@ class DataFrame {
                                   double min = 0.0,
                                   double max = 1.0,
                                   std::uint32_t seed = 0);
+  static DataFrame simulate_ar1_paths(std::size_t steps,
+                                      std::size_t paths,
+                                      double phi,
+                                      double sigma_eps,
+                                      double mu = 0.0,
+                                      std::size_t burnin = 0,
+                                      std::uint64_t seed = 0);
+  static DataFrame simulate_arma_paths(std::size_t steps,
+                                       std::size_t paths,
+                                       const std::vector<double>& phi,
+                                       const std::vector<double>& theta,
+                                       double sigma_eps,
+                                       double mu = 0.0,
+                                       std::size_t burnin = 0,
+                                       std::uint64_t seed = 0);
+  static DataFrame simulate_garch_paths(std::size_t steps,
+                                        std::size_t paths,
+                                        double omega,
+                                        double alpha,
+                                        double beta,
+                                        double mu = 0.0,
+                                        std::size_t burnin = 0,
+                                        std::uint64_t seed = 0);
 
   void to_csv(std::ostream& output,
               bool include_header = true,
@@ -232,12 +870,26 @@ class DataFrame {
   void to_csv_file(const std::string& path,
                    bool include_header = true,
                    bool include_index = true) const;
-  void to_binary(std::ostream& output) const;
-  void to_binary_file(const std::string& path) const;
+  void to_binary(std::ostream& output,
+                 BinaryCompression compression = BinaryCompression::none) const;
+  void to_binary_file(const std::string& path,
+                      BinaryCompression compression = BinaryCompression::none) const;
+  void to_arrow_ipc_file(const std::string& path, std::size_t batch_rows = 65536) const;
 
   DataFrame differences() const;
   DataFrame log_changes() const;
   DataFrame proportional_changes() const;
+  DataFrame shift(long long periods = 1) const;
+  DataFrame diff(long long periods = 1) const;
+  DataFrame pct_change(long long periods = 1) const;
+  DataFrame log_change(long long periods = 1) const;
+  DataFrame multi_lag_changes(const std::vector<long long>& lags,
+                              ChangeKind kind = ChangeKind::proportional) const;
+  DataFrame cumsum() const;
+  DataFrame cumprod() const;
+  DataFrame cummax() const;
+  DataFrame cummin() const;
+  DataFrame wealth_index(bool log_returns = false, double initial = 1.0) const;
   DataFrame add(double value) const;
   DataFrame subtract(double value) const;
   DataFrame multiply(double value) const;
@@ -252,9 +904,22 @@ class DataFrame {
   DataFrame power_int(int exponent) const;
   DataFrame standardize() const;
   DataFrame normalize() const;
+  DataFrame cross_sectional_rank(bool pct = false) const;
+  DataFrame cross_sectional_zscore() const;
+  DataFrame cross_sectional_demean() const;
+  DataFrame cross_sectional_winsorize(double lower_percentile, double upper_percentile) const;
   DataFrame select_rows(const std::vector<IndexT>& values) const;
   DataFrame select_columns(const std::vector<std::string>& names) const;
   void add_column(const std::string& name, const std::vector<double>& values);
+  void append_row(const IndexT& index_value, const std::vector<double>& values);
+  void append_row(const IndexT& index_value, const double* values, std::size_t count);
+  void append_rows(const DataFrame& batch);
+  void reserve_rows(std::size_t capacity);
+  void reserve_columns(std::size_t capacity);
+  void ffill(std::size_t limit = 0);
+  void bfill(std::size_t limit = 0);
+  void interpolate();
+  std::size_t row_capacity() const { return data_.capacity(); }
   template <typename T = IndexT,
             typename = std::enable_if_t<detail::is_orderable_index<T>::value>>
   DataFrame slice_rows_range(IndexT start,
@@ -270,14 +935,49 @@ class DataFrame {
   void to_column_major(double* out, std::size_t column_stride = 0) const;
   DataFrame sort_rows_by_column(const std::string& column_name,
                                 bool ascending = true) const;
+  DataFrame sort_rows_by_columns(const std::vector<std::string>& column_names,
+                                 const std::vector<bool>& ascending = {}) const;
+  std::vector<std::size_t> argsort_rows(const std::vector<std::string>& column_names,
+                                        const std::vector<bool>& ascending = {}) const;
   DataFrame sort_columns_by_row(const IndexT& index_value,
                                 bool ascending = true) const;
+  DataFrame nlargest(std::size_t count, const std::string& column_name) const;
+  DataFrame nsmallest(std::size_t count, const std::string& column_name) const;
+  DataFrame top_k_columns(const IndexT& index_value,
+                          std::size_t count,
+                          bool largest = true) const;
   DataFrame rolling_mean(std::size_t window) const;
   DataFrame rolling_std(std::size_t window) const;
   DataFrame rolling_rms(std::size_t window) const;
   DataFrame exponential_moving_average(double alpha) const;
+  DataFrame ewm_var(double alpha, bool demean = true) const;
+  DataFrame ewm_std(double alpha, bool demean = true) const;
+  DataFrame<std::string> ewm_cov_matrix(double alpha, bool demean = true) const;
+  DataFrame<std::string> garch_fit_dataframe() const;
+  DataFrame garch_volatility() const;
+  DataFrame garch_volatility(const DataFrame<std::string>& fits) const;
+  DataFrame ewma_volatility(double lambda = 0.94) const;
+  // Returns divided by cond_sd, column by column through
+  // stats::standardize_returns; cells whose sd is nonpositive or non-finite
+  // (e.g. GARCH warm-up rows) get fill_value, NaN unless the caller opts in.
+  DataFrame standardize_returns(const DataFrame& cond_sd,
+                                double fill_value = std::numeric_limits<double>::quiet_NaN()) const;
+  DataFrame resample_time(Duration bucket,
+                          const std::vector<std::pair<std::string, Aggregation>>& aggregations) const;
+  DataFrame resample_time(Duration bucket, Aggregation aggregation = Aggregation::last) const;
+  // Seeds like BootstrapOptions::seed (0 draws from std::random_device); a
+  // given seed yields the rows of bootstrap replicate 0 with that seed.
   DataFrame resample_rows(std::size_t sample_size = 0,
-                          bool reset_index = true) const;
+                          bool reset_index = true,
+                          std::uint64_t seed = 0) const;
+  template <typename Statistic>
+  DataFrame<int> bootstrap(const std::vector<std::string>& labels,
+                           Statistic statistic,
+                           const BootstrapOptions& options = BootstrapOptions()) const;
+  DataFrame<int> bootstrap_column_means(const BootstrapOptions& options = BootstrapOptions()) const;
+  DataFrame<int> bootstrap_column_percentiles(double percentile,
+                                              const BootstrapOptions& options = BootstrapOptions()) const;
+  DataFrame<int> bootstrap_correlations(const BootstrapOptions& options = BootstrapOptions()) const;
   DataFrame remove_rows_with_nan() const;
   DataFrame remove_columns_with_nan() const;
   DataFrame<std::string> column_stats_dataframe() const;
@@ -286,6 +986,14 @@ class DataFrame {
   DataFrame<std::string> kendall_tau_matrix() const;
   DataFrame<std::string> column_percentiles(const std::vector<double>& percentiles) const;
   DataFrame<std::string> covariance_matrix() const;
+  ShrunkCovariance shrunk_covariance_matrix(
+      ShrinkageTarget target = ShrinkageTarget::scaled_identity) const;
+  DataFrame<int> autocorrelation_matrix(std::size_t max_lag) const;
+  OlsFit<IndexT> ols(const std::string& y_column, const std::vector<std::string>& x_columns) const;
+  DataFrame rolling_ols(const std::string& y_column,
+                        const std::vector<std::string>& x_columns,
+                        std::size_t window) const;
+  PcaResult<IndexT> pca(std::size_t n_components = 0, bool use_correlation = false) const;
 
   std::size_t rows() const { return data_.size(); }
   std::size_t cols() const { return columns_.size(); }
@@ -295,7 +1003,19 @@ class DataFrame {
   void set_index_name(const std::string& name) { index_name_ = name; }
   std::vector<std::size_t> shape() const { return {rows(), cols()}; }
 
+  // Freezes a copy (or, for an rvalue, the frame itself) into shared immutable
+  // storage; see FrozenDataFrame.
+  FrozenDataFrame<IndexT> share() const&;
+  FrozenDataFrame<IndexT> share() &&;
+
   double value(std::size_t row, std::size_t col) const;
+
+  // Zero-copy view of the frame's values for the matrix kernels; valid while
+  // the frame is alive and its rows are not reallocated.
+  MatrixView matrix_view() const;
+  template <typename OtherIndexT>
+  DataFrame matmul(const DataFrame<OtherIndexT>& other) const;
+  DataFrame dot(const std::vector<double>& weights, const std::string& name = "dot") const;
 
  private:
   std::vector<std::string> columns_;
@@ -314,6 +1034,40 @@ class DataFrame {
 
   DataFrame select_rows_by_positions(const std::vector<std::size_t>& positions) const;
 
+  static DataFrame make_path_frame(std::size_t steps, std::size_t paths, const char* name);
+
+  std::vector<std::size_t> complete_row_positions() const;
+
+  MatrixView rows_view(const std::vector<std::size_t>& positions) const;
+  void write_compressed_binary(std::ostream& output) const;
+  static DataFrame read_compressed_binary(std::istream& input);
+
+  template <typename Func>
+  DataFrame apply_by_column(Func func) const;
+
+  template <typename Func>
+  DataFrame apply_by_row(Func func) const;
+
+  template <typename Func>
+  DataFrame lagged_transform(long long lag, bool trim, Func func) const;
+
+  template <typename Op, typename Prepare, typename Finish>
+  DataFrame cumulative_scan(Op op, Prepare prepare, Finish finish) const;
+
+  void correlations_over_positions(const std::vector<std::size_t>& positions,
+                                   std::vector<std::vector<double>>& out) const;
+
+  void cross_products_over_positions(const std::vector<std::size_t>& positions,
+                                     const std::vector<std::size_t>& column_ids,
+                                     const std::vector<double>& centers,
+                                     std::vector<double>& out) const;
+
+  void shrinkage_moments_over_positions(const std::vector<std::size_t>& positions,
+                                        const std::vector<double>& centers,
+                                        std::vector<double>& second,
+                                        std::vector<double>& squares,
+                                        std::vector<double>& cubes) const;
+
   DataFrame select_columns_by_positions(const std::vector<std::size_t>& positions) const;
 
   std::vector<std::size_t> find_row_positions_in_range(IndexT start,
@@ -325,6 +1079,37 @@ class DataFrame {
   std::size_t find_row_position(const IndexT& value) const;
 };
 
+// Result of DataFrame::ols. coefficients is indexed by term ("intercept", then
+// each regressor) with columns coefficient, std_error and t_stat; residuals
+// keeps the source index and is NaN on rows skipped for missing values.
+template <typename IndexT>
+struct OlsFit {
+  DataFrame<std::string> coefficients;
+  DataFrame<IndexT> residuals;
+  double r_squared = std::numeric_limits<double>::quiet_NaN();
+  double residual_sd = std::numeric_limits<double>::quiet_NaN();
+  std::size_t n = 0;
+};
+
+// Result of DataFrame::pca. loadings is indexed by source column with one
+// column per component (pc1, pc2, ...); explained_variance is indexed by
+// component with columns variance, ratio and cumulative_ratio; scores keeps the
+// source index and is NaN on rows with a missing value.
+template <typename IndexT>
+struct PcaResult {
+  DataFrame<std::string> loadings;
+  DataFrame<std::string> explained_variance;
+  DataFrame<IndexT> scores;
+};
+
+// Result of DataFrame::shrunk_covariance_matrix: shrinkage * target +
+// (1 - shrinkage) * sample covariance, laid out like covariance_matrix.
+struct ShrunkCovariance {
+  DataFrame<std::string> covariance;
+  double shrinkage = 0.0;
+  ShrinkageTarget target = ShrinkageTarget::scaled_identity;
+};
+
 template <typename IndexT>
 DataFrame<IndexT> DataFrame<IndexT>::from_csv(std::istream& input, bool has_index) {
   std::string header;
@@ -432,8 +1217,12 @@ DataFrame<IndexT> DataFrame<IndexT>::from_vectors(const std::vector<IndexT>& ind
 template <typename IndexT>
 DataFrame<IndexT> DataFrame<IndexT>::from_binary(std::istream& input) {
   const char expected_magic[] = {'D', 'F', 'B', 'I', 'N', '1'};
+  const char compressed_magic[] = {'D', 'F', 'B', 'I', 'N', '2'};
   char magic[sizeof(expected_magic)];
   input.read(magic, sizeof(magic));
+  if (input && std::memcmp(magic, compressed_magic, sizeof(compressed_magic)) == 0) {
+    return read_compressed_binary(input);
+  }
   if (!input || std::memcmp(magic, expected_magic, sizeof(expected_magic)) != 0) {
     throw std::runtime_error("dataframe::from_binary: invalid file header");
   }
@@ -551,10 +1340,14 @@ void DataFrame<IndexT>::to_csv_file(const std::string& path,
 }
 
 template <typename IndexT>
-void DataFrame<IndexT>::to_binary(std::ostream& output) const {
+void DataFrame<IndexT>::to_binary(std::ostream& output, BinaryCompression compression) const {
   if (!output.good()) {
     throw std::runtime_error("dataframe::to_binary: output stream is not writable");
   }
+  if (compression == BinaryCompression::automatic) {
+    write_compressed_binary(output);
+    return;
+  }
   const char magic[] = {'D', 'F', 'B', 'I', 'N', '1'};
   output.write(magic, sizeof(magic));
   if (!output) {
@@ -582,95 +1375,439 @@ void DataFrame<IndexT>::to_binary(std::ostream& output) const {
 }
 
 template <typename IndexT>
-void DataFrame<IndexT>::to_binary_file(const std::string& path) const {
+void DataFrame<IndexT>::to_binary_file(const std::string& path,
+                                       BinaryCompression compression) const {
   std::ofstream file(path, std::ios::binary | std::ios::trunc);
   if (!file.is_open()) {
     throw std::runtime_error("dataframe::to_binary_file: unable to open output file");
   }
-  to_binary(file);
+  to_binary(file, compression);
   if (!file.good()) {
     throw std::runtime_error("dataframe::to_binary_file: failed while writing file");
   }
 }
 
+// Compressed snapshot: the DFBIN1 header fields, then one block for the index
+// and one per column, each an encoding byte, a payload length and the payload.
+// Columns are gathered out of the rows and encoded in parallel; Date and
+// DateTime indices are stored as day / second ticks.
 template <typename IndexT>
-DataFrame<IndexT> DataFrame<IndexT>::random_normal(std::size_t rows,
-                                                   const std::vector<std::string>& columns,
-                                                   double mean,
-                                                   double stddev,
-                                                   std::uint32_t seed,
-                                                   double target_corr) {
-  static_assert(std::is_integral_v<IndexT>, "random_normal requires integral indices");
-  if (columns.empty()) {
-    throw std::runtime_error("random_normal: at least one column is required");
-  }
-  if (stddev <= 0.0) {
-    throw std::runtime_error("random_normal: standard deviation must be positive");
+void DataFrame<IndexT>::write_compressed_binary(std::ostream& output) const {
+  const char magic[] = {'D', 'F', 'B', 'I', 'N', '2'};
+  output.write(magic, sizeof(magic));
+  if (!output) {
+    throw std::runtime_error("dataframe::to_binary: failed to write header");
   }
-  if (target_corr < 0.0 || target_corr > 1.0) {
-    throw std::runtime_error("random_normal: target correlation must be in [0, 1]");
+  const std::size_t n = rows();
+  const std::size_t k = cols();
+  detail::write_pod<std::uint64_t>(output, static_cast<std::uint64_t>(n));
+  detail::write_pod<std::uint64_t>(output, static_cast<std::uint64_t>(k));
+  detail::write_string(output, index_name_);
+  detail::write_pod<std::uint64_t>(output, static_cast<std::uint64_t>(k));
+  for (const auto& name : columns_) {
+    detail::write_string(output, name);
   }
 
-  if (rows > static_cast<std::size_t>(std::numeric_limits<IndexT>::max())) {
-    throw std::runtime_error("random_normal: row count exceeds index capacity");
-  }
-
-  DataFrame<IndexT> df;
-  df.columns_ = columns;
-  df.index_name_ = "index";
-  df.index_.reserve(rows);
-  df.data_.reserve(rows);
-
-  std::mt19937 rng(seed == 0 ? std::mt19937::result_type(std::random_device{}()) : seed);
-  std::normal_distribution<double> dist(mean, stddev);
-
-  if (df.columns_.size() <= 1 || target_corr == 0.0) {
-    for (std::size_t row = 0; row < rows; ++row) {
-      df.index_.push_back(static_cast<IndexT>(row));
-      std::vector<double> row_values;
-      row_values.reserve(df.columns_.size());
-      for (std::size_t col = 0; col < df.columns_.size(); ++col) {
-        row_values.push_back(dist(rng));
+  auto write_block = [&output](codec::Encoding encoding, const std::vector<std::uint8_t>& payload) {
+    detail::write_pod<std::uint8_t>(output, static_cast<std::uint8_t>(encoding));
+    detail::write_pod<std::uint64_t>(output, static_cast<std::uint64_t>(payload.size()));
+    output.write(reinterpret_cast<const char*>(payload.data()),
+                 static_cast<std::streamsize>(payload.size()));
+  };
+
+  std::vector<std::uint8_t> index_payload;
+  codec::Encoding index_encoding = codec::Encoding::raw;
+  if constexpr (std::is_same_v<IndexT, std::string>) {
+    std::ostringstream strings;
+    for (const auto& value : index_) {
+      detail::write_string(strings, value);
+    }
+    const std::string bytes = strings.str();
+    index_payload.assign(bytes.begin(), bytes.end());
+  } else if constexpr (std::is_floating_point_v<IndexT>) {
+    std::vector<double> values(index_.begin(), index_.end());
+    index_encoding = codec::choose_double_encoding(values.data(), n);
+    codec::encode_doubles(index_encoding, values.data(), n, index_payload);
+  } else {
+    std::vector<std::int64_t> ticks(n);
+    for (std::size_t r = 0; r < n; ++r) {
+      if constexpr (std::is_same_v<IndexT, Date>) {
+        ticks[r] = static_cast<std::int64_t>(days_since_epoch(index_[r]));
+      } else if constexpr (std::is_same_v<IndexT, DateTime>) {
+        ticks[r] = static_cast<std::int64_t>(seconds_since_epoch(index_[r]));
+      } else if constexpr (std::is_integral_v<IndexT>) {
+        ticks[r] = static_cast<std::int64_t>(index_[r]);
+      } else {
+        static_assert(detail::dependent_false<IndexT>::value,
+                      "dataframe::to_binary: unsupported index type");
       }
-      df.data_.push_back(std::move(row_values));
     }
-    return df;
+    index_encoding = codec::choose_integer_encoding(ticks.data(), n);
+    codec::encode_integers(index_encoding, ticks.data(), n, index_payload);
   }
+  write_block(index_encoding, index_payload);
 
-  const double corr = target_corr;
-  const double coeff1 = std::sqrt(corr);
-  const double coeff2 = std::sqrt(1.0 - corr);
-
-  for (std::size_t row = 0; row < rows; ++row) {
-    df.index_.push_back(static_cast<IndexT>(row));
-    std::vector<double> row_values(df.columns_.size(), 0.0);
-    double common = dist(rng);
-    row_values[0] = common;
-    for (std::size_t col = 1; col < df.columns_.size(); ++col) {
-      double independent = dist(rng);
-      row_values[col] = coeff1 * common + coeff2 * independent;
+  std::vector<codec::Encoding> encodings(k, codec::Encoding::raw);
+  std::vector<std::vector<std::uint8_t>> payloads(k);
+  detail::parallel_for(k, [&](std::size_t begin, std::size_t end) {
+    std::vector<double> column(n);
+    for (std::size_t c = begin; c < end; ++c) {
+      for (std::size_t r = 0; r < n; ++r) column[r] = data_[r][c];
+      encodings[c] = codec::choose_double_encoding(column.data(), n);
+      codec::encode_doubles(encodings[c], column.data(), n, payloads[c]);
     }
-    df.data_.push_back(std::move(row_values));
+  });
+  for (std::size_t c = 0; c < k; ++c) {
+    write_block(encodings[c], payloads[c]);
+  }
+  if (!output.good()) {
+    throw std::runtime_error("dataframe::to_binary: failed while writing data");
   }
-
-  return df;
 }
 
 template <typename IndexT>
-DataFrame<IndexT> DataFrame<IndexT>::random_uniform(std::size_t rows,
-                                                    const std::vector<std::string>& columns,
-                                                    double min,
-                                                    double max,
-                                                    std::uint32_t seed) {
-  static_assert(std::is_integral_v<IndexT>, "random_uniform requires integral indices");
-  if (columns.empty()) {
-    throw std::runtime_error("random_uniform: at least one column is required");
+DataFrame<IndexT> DataFrame<IndexT>::read_compressed_binary(std::istream& input) {
+  const auto row_count = detail::read_pod<std::uint64_t>(input);
+  const auto col_count = detail::read_pod<std::uint64_t>(input);
+  if (row_count > static_cast<std::uint64_t>(std::numeric_limits<std::size_t>::max() / 8) ||
+      col_count > static_cast<std::uint64_t>(std::numeric_limits<std::size_t>::max() / 8)) {
+    throw std::runtime_error("dataframe::from_binary: dimensions too large");
   }
-  if (min >= max) {
-    throw std::runtime_error("random_uniform: min must be less than max");
+  const std::size_t n = static_cast<std::size_t>(row_count);
+  const std::size_t k = static_cast<std::size_t>(col_count);
+
+  DataFrame<IndexT> df;
+  df.index_name_ = detail::read_string(input);
+  if (detail::read_pod<std::uint64_t>(input) != col_count) {
+    throw std::runtime_error("dataframe::from_binary: column metadata mismatch");
   }
-  if (rows > static_cast<std::size_t>(std::numeric_limits<IndexT>::max())) {
-    throw std::runtime_error("random_uniform: row count exceeds index capacity");
+  df.columns_.resize(k);
+  for (std::size_t i = 0; i < k; ++i) {
+    df.columns_[i] = detail::read_string(input);
+  }
+
+  // Payloads are read in bounded chunks so a corrupt length fails on the
+  // short read instead of allocating the claimed size up front.
+  auto read_block = [&input](codec::Encoding& encoding, std::vector<std::uint8_t>& payload) {
+    encoding = static_cast<codec::Encoding>(detail::read_pod<std::uint8_t>(input));
+    std::uint64_t remaining = detail::read_pod<std::uint64_t>(input);
+    payload.clear();
+    while (remaining > 0) {
+      const std::size_t chunk =
+          static_cast<std::size_t>(std::min<std::uint64_t>(remaining, std::uint64_t(1) << 24));
+      const std::size_t offset = payload.size();
+      payload.resize(offset + chunk);
+      input.read(reinterpret_cast<char*>(payload.data() + offset), static_cast<std::streamsize>(chunk));
+      if (!input) {
+        throw std::runtime_error("dataframe::from_binary: truncated column block");
+      }
+      remaining -= chunk;
+    }
+  };
+
+  codec::Encoding index_encoding = codec::Encoding::raw;
+  std::vector<std::uint8_t> index_payload;
+  read_block(index_encoding, index_payload);
+  if constexpr (std::is_same_v<IndexT, std::string>) {
+    std::istringstream strings(std::string(index_payload.begin(), index_payload.end()));
+    df.index_.reserve(n);
+    for (std::size_t r = 0; r < n; ++r) {
+      df.index_.push_back(detail::read_string(strings));
+    }
+  } else if constexpr (std::is_floating_point_v<IndexT>) {
+    std::vector<double> values(n);
+    codec::decode_doubles(index_encoding, index_payload.data(), index_payload.size(), values.data(), n);
+    df.index_.assign(values.begin(), values.end());
+  } else {
+    std::vector<std::int64_t> ticks(n);
+    codec::decode_integers(index_encoding, index_payload.data(), index_payload.size(), ticks.data(), n);
+    df.index_.reserve(n);
+    for (std::int64_t tick : ticks) {
+      if constexpr (std::is_same_v<IndexT, Date>) {
+        df.index_.push_back(date_from_days(tick));
+      } else if constexpr (std::is_same_v<IndexT, DateTime>) {
+        df.index_.push_back(datetime_from_seconds(tick));
+      } else if constexpr (std::is_integral_v<IndexT>) {
+        df.index_.push_back(static_cast<IndexT>(tick));
+      } else {
+        static_assert(detail::dependent_false<IndexT>::value,
+                      "dataframe::from_binary: unsupported index type");
+      }
+    }
+  }
+
+  std::vector<codec::Encoding> encodings(k);
+  std::vector<std::vector<std::uint8_t>> payloads(k);
+  for (std::size_t c = 0; c < k; ++c) {
+    read_block(encodings[c], payloads[c]);
+  }
+  std::vector<double> columns(n * k);
+  detail::parallel_for(k, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = begin; c < end; ++c) {
+      codec::decode_doubles(encodings[c], payloads[c].data(), payloads[c].size(), &columns[c * n], n);
+      std::vector<std::uint8_t>().swap(payloads[c]);
+    }
+  });
+  df.data_.assign(n, std::vector<double>(k));
+  detail::parallel_for(n, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t r = begin; r < end; ++r) {
+      for (std::size_t c = 0; c < k; ++c) df.data_[r][c] = columns[c * n + r];
+    }
+  }, 4096);
+  return df;
+}
+
+// Writes the frame as an Arrow IPC file (Feather v2) readable by pyarrow,
+// pandas.read_feather and polars. The index becomes the first field (Date ->
+// date32, DateTime -> timestamp[s], integers -> int64, strings -> dictionary
+// encoded utf8), every column a float64 field with NaN stored as null.
+template <typename IndexT>
+void DataFrame<IndexT>::to_arrow_ipc_file(const std::string& path, std::size_t batch_rows) const {
+  if (batch_rows == 0) {
+    throw std::runtime_error("dataframe::to_arrow_ipc_file: batch_rows must be positive");
+  }
+  const std::size_t k = columns_.size();
+  std::vector<arrow_ipc::WriteField> fields(k + 1);
+  fields[0].name = index_name_;
+  std::vector<std::int32_t> index_codes;
+  if constexpr (std::is_same_v<IndexT, Date>) {
+    fields[0].type = arrow_ipc::ColumnType::date32;
+  } else if constexpr (std::is_same_v<IndexT, DateTime>) {
+    fields[0].type = arrow_ipc::ColumnType::timestamp_seconds;
+  } else if constexpr (std::is_integral_v<IndexT>) {
+    fields[0].type = arrow_ipc::ColumnType::int64;
+  } else if constexpr (std::is_floating_point_v<IndexT>) {
+    fields[0].type = arrow_ipc::ColumnType::float64;
+  } else if constexpr (std::is_same_v<IndexT, std::string>) {
+    fields[0].type = arrow_ipc::ColumnType::dictionary_utf8;
+    std::unordered_map<std::string, std::int32_t> codes;
+    index_codes.reserve(index_.size());
+    for (const auto& value : index_) {
+      auto inserted = codes.emplace(value, static_cast<std::int32_t>(fields[0].dictionary.size()));
+      if (inserted.second) fields[0].dictionary.push_back(value);
+      index_codes.push_back(inserted.first->second);
+    }
+  } else {
+    static_assert(detail::dependent_false<IndexT>::value,
+                  "dataframe::to_arrow_ipc_file: unsupported index type");
+  }
+  for (std::size_t c = 0; c < k; ++c) {
+    fields[c + 1].name = columns_[c];
+  }
+
+  arrow_ipc::FileWriter writer(path, std::move(fields));
+  const std::size_t batch = std::min(batch_rows, std::max<std::size_t>(rows(), 1));
+  std::vector<std::int64_t> index_wide(batch);
+  std::vector<std::int32_t> index_narrow(batch);
+  std::vector<double> index_double(batch);
+  std::vector<double> values(batch * k);
+  std::vector<arrow_ipc::WriteColumn> columns(k + 1);
+  for (std::size_t start = 0; start < rows(); start += batch) {
+    const std::size_t length = std::min(batch, rows() - start);
+    for (std::size_t i = 0; i < length; ++i) {
+      const IndexT& value = index_[start + i];
+      if constexpr (std::is_same_v<IndexT, Date>) {
+        index_narrow[i] = static_cast<std::int32_t>(days_since_epoch(value));
+      } else if constexpr (std::is_same_v<IndexT, DateTime>) {
+        index_wide[i] = static_cast<std::int64_t>(seconds_since_epoch(value));
+      } else if constexpr (std::is_integral_v<IndexT>) {
+        index_wide[i] = static_cast<std::int64_t>(value);
+      } else if constexpr (std::is_floating_point_v<IndexT>) {
+        index_double[i] = static_cast<double>(value);
+      } else {
+        index_narrow[i] = index_codes[start + i];
+      }
+    }
+    if constexpr (std::is_same_v<IndexT, DateTime> || std::is_integral_v<IndexT>) {
+      columns[0].values = index_wide.data();
+    } else if constexpr (std::is_floating_point_v<IndexT>) {
+      columns[0].values = index_double.data();
+    } else {
+      columns[0].values = index_narrow.data();
+    }
+
+    // Transpose the row-major block into one contiguous buffer per column.
+    const std::size_t bitmap_size = (length + 7) / 8;
+    for (std::size_t c = 0; c < k; ++c) {
+      double* column = &values[c * length];
+      arrow_ipc::WriteColumn& out = columns[c + 1];
+      out.values = column;
+      out.validity.assign(bitmap_size, 0);
+      out.null_count = 0;
+      for (std::size_t i = 0; i < length; ++i) {
+        const double value = data_[start + i][c];
+        column[i] = value;
+        if (std::isnan(value)) {
+          ++out.null_count;
+        } else {
+          out.validity[i >> 3] |= static_cast<std::uint8_t>(1u << (i & 7));
+        }
+      }
+      if (out.null_count == 0) out.validity.clear();
+    }
+    writer.write_batch(length, columns);
+  }
+  writer.close();
+}
+
+// Reads an Arrow IPC file (Feather v2). The index is the pandas index
+// column when the schema carries pandas metadata, otherwise the first field;
+// every other field must be numeric and becomes a double column (nulls -> NaN).
+// The file is memory-mapped and values are transposed straight from the
+// mapping into rows.
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::from_arrow_ipc_file(const std::string& path) {
+  arrow_ipc::FileReader reader(path);
+  const auto& fields = reader.fields();
+  if (fields.empty()) {
+    throw std::runtime_error("dataframe::from_arrow_ipc_file: file has no fields");
+  }
+  std::size_t index_field = 0;
+  const std::string& pandas_index = reader.pandas_index_column();
+  for (std::size_t f = 0; f < fields.size() && !pandas_index.empty(); ++f) {
+    if (fields[f].name == pandas_index) {
+      index_field = f;
+      break;
+    }
+  }
+
+  DataFrame<IndexT> df;
+  df.index_name_ = fields[index_field].name;
+  std::vector<std::size_t> sources;
+  for (std::size_t f = 0; f < fields.size(); ++f) {
+    if (f == index_field) continue;
+    if (fields[f].kind == arrow_ipc::TypeKind::utf8) {
+      throw std::runtime_error("dataframe::from_arrow_ipc_file: column '" + fields[f].name +
+                               "' is not numeric");
+    }
+    df.columns_.push_back(fields[f].name);
+    sources.push_back(f);
+  }
+  std::size_t total = 0;
+  for (std::size_t b = 0; b < reader.batch_count(); ++b) total += reader.batch_length(b);
+  df.index_.reserve(total);
+  df.data_.reserve(total);
+
+  for (std::size_t b = 0; b < reader.batch_count(); ++b) {
+    const std::size_t length = reader.batch_length(b);
+    if constexpr (std::is_same_v<IndexT, Date> || std::is_same_v<IndexT, DateTime>) {
+      for (long long seconds : reader.read_epoch_seconds(b, index_field)) {
+        if constexpr (std::is_same_v<IndexT, Date>) {
+          const long long days = seconds >= 0 ? seconds / 86400 : -((-seconds + 86399) / 86400);
+          df.index_.push_back(date_from_days(days));
+        } else {
+          df.index_.push_back(datetime_from_seconds(seconds));
+        }
+      }
+    } else if constexpr (std::is_integral_v<IndexT>) {
+      for (long long value : reader.read_integers(b, index_field)) {
+        df.index_.push_back(static_cast<IndexT>(value));
+      }
+    } else if constexpr (std::is_floating_point_v<IndexT>) {
+      for (double value : reader.read_doubles(b, index_field)) {
+        df.index_.push_back(static_cast<IndexT>(value));
+      }
+    } else if constexpr (std::is_same_v<IndexT, std::string>) {
+      for (auto& value : reader.read_strings(b, index_field)) {
+        df.index_.push_back(std::move(value));
+      }
+    } else {
+      static_assert(detail::dependent_false<IndexT>::value,
+                    "dataframe::from_arrow_ipc_file: unsupported index type");
+    }
+    const std::size_t first = df.data_.size();
+    df.data_.resize(first + length, std::vector<double>(sources.size()));
+    for (std::size_t c = 0; c < sources.size(); ++c) {
+      const std::vector<double> column = reader.read_doubles(b, sources[c]);
+      for (std::size_t i = 0; i < length; ++i) {
+        df.data_[first + i][c] = column[i];
+      }
+    }
+  }
+  if (df.index_.size() != df.data_.size()) {
+    throw std::runtime_error("dataframe::from_arrow_ipc_file: index length mismatch");
+  }
+  return df;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::random_normal(std::size_t rows,
+                                                   const std::vector<std::string>& columns,
+                                                   double mean,
+                                                   double stddev,
+                                                   std::uint32_t seed,
+                                                   double target_corr) {
+  static_assert(std::is_integral_v<IndexT>, "random_normal requires integral indices");
+  if (columns.empty()) {
+    throw std::runtime_error("random_normal: at least one column is required");
+  }
+  if (stddev <= 0.0) {
+    throw std::runtime_error("random_normal: standard deviation must be positive");
+  }
+  if (target_corr < 0.0 || target_corr > 1.0) {
+    throw std::runtime_error("random_normal: target correlation must be in [0, 1]");
+  }
+
+  if (rows > static_cast<std::size_t>(std::numeric_limits<IndexT>::max())) {
+    throw std::runtime_error("random_normal: row count exceeds index capacity");
+  }
+
+  DataFrame<IndexT> df;
+  df.columns_ = columns;
+  df.index_name_ = "index";
+  df.index_.reserve(rows);
+  df.data_.reserve(rows);
+
+  std::mt19937 rng(seed == 0 ? std::mt19937::result_type(std::random_device{}()) : seed);
+  std::normal_distribution<double> dist(mean, stddev);
+
+  if (df.columns_.size() <= 1 || target_corr == 0.0) {
+    for (std::size_t row = 0; row < rows; ++row) {
+      df.index_.push_back(static_cast<IndexT>(row));
+      std::vector<double> row_values;
+      row_values.reserve(df.columns_.size());
+      for (std::size_t col = 0; col < df.columns_.size(); ++col) {
+        row_values.push_back(dist(rng));
+      }
+      df.data_.push_back(std::move(row_values));
+    }
+    return df;
+  }
+
+  const double corr = target_corr;
+  const double coeff1 = std::sqrt(corr);
+  const double coeff2 = std::sqrt(1.0 - corr);
+
+  for (std::size_t row = 0; row < rows; ++row) {
+    df.index_.push_back(static_cast<IndexT>(row));
+    std::vector<double> row_values(df.columns_.size(), 0.0);
+    double common = dist(rng);
+    row_values[0] = common;
+    for (std::size_t col = 1; col < df.columns_.size(); ++col) {
+      double independent = dist(rng);
+      row_values[col] = coeff1 * common + coeff2 * independent;
+    }
+    df.data_.push_back(std::move(row_values));
+  }
+
+  return df;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::random_uniform(std::size_t rows,
+                                                    const std::vector<std::string>& columns,
+                                                    double min,
+                                                    double max,
+                                                    std::uint32_t seed) {
+  static_assert(std::is_integral_v<IndexT>, "random_uniform requires integral indices");
+  if (columns.empty()) {
+    throw std::runtime_error("random_uniform: at least one column is required");
+  }
+  if (min >= max) {
+    throw std::runtime_error("random_uniform: min must be less than max");
+  }
+  if (rows > static_cast<std::size_t>(std::numeric_limits<IndexT>::max())) {
+    throw std::runtime_error("random_uniform: row count exceeds index capacity");
   }
 
   DataFrame<IndexT> df;
@@ -695,22 +1832,158 @@ DataFrame<IndexT> DataFrame<IndexT>::random_uniform(std::size_t rows,
   return df;
 }
 
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::make_path_frame(std::size_t steps,
+                                                     std::size_t paths,
+                                                     const char* name) {
+  static_assert(std::is_integral_v<IndexT>, "path simulation requires integral indices");
+  if (steps == 0) {
+    throw std::runtime_error(std::string(name) + ": steps must be positive");
+  }
+  if (paths == 0) {
+    throw std::runtime_error(std::string(name) + ": at least one path is required");
+  }
+  if (steps > static_cast<std::size_t>(std::numeric_limits<IndexT>::max())) {
+    throw std::runtime_error(std::string(name) + ": step count exceeds index capacity");
+  }
+  DataFrame<IndexT> df;
+  df.index_name_ = "step";
+  df.columns_.reserve(paths);
+  for (std::size_t p = 0; p < paths; ++p) {
+    df.columns_.push_back("path_" + std::to_string(p));
+  }
+  df.index_.resize(steps);
+  for (std::size_t t = 0; t < steps; ++t) df.index_[t] = static_cast<IndexT>(t);
+  df.data_.assign(steps, std::vector<double>(paths, 0.0));
+  return df;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::simulate_ar1_paths(std::size_t steps,
+                                                        std::size_t paths,
+                                                        double phi,
+                                                        double sigma_eps,
+                                                        double mu,
+                                                        std::size_t burnin,
+                                                        std::uint64_t seed) {
+  return simulate_arma_paths(steps, paths, {phi}, {}, sigma_eps, mu, burnin, seed);
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::simulate_arma_paths(std::size_t steps,
+                                                         std::size_t paths,
+                                                         const std::vector<double>& phi,
+                                                         const std::vector<double>& theta,
+                                                         double sigma_eps,
+                                                         double mu,
+                                                         std::size_t burnin,
+                                                         std::uint64_t seed) {
+  if (!(sigma_eps >= 0.0)) {
+    throw std::runtime_error("simulate_arma_paths: sigma must be >= 0");
+  }
+  DataFrame<IndexT> df = make_path_frame(steps, paths, "simulate_arma_paths");
+  const std::uint64_t base_seed = detail::resolve_seed(seed);
+  const std::size_t p_order = phi.size();
+  const std::size_t q_order = theta.size();
+  const std::size_t total = burnin + steps;
+
+  // Paths are split into column blocks; within a block every step advances all
+  // paths together with inner loops over contiguous per-lag state arrays.
+  detail::parallel_for(paths, [&](std::size_t begin, std::size_t end) {
+    const std::size_t width = end - begin;
+    std::vector<std::uint64_t> streams(width);
+    for (std::size_t j = 0; j < width; ++j) {
+      streams[j] = detail::splitmix64(base_seed ^ detail::splitmix64(begin + j));
+    }
+    // Ring buffers of past deviations from mu and past shocks, one row per lag.
+    std::vector<double> x_hist(p_order * width, 0.0);
+    std::vector<double> e_hist(q_order * width, 0.0);
+    std::size_t x_head = 0;
+    std::size_t e_head = 0;
+    std::vector<double> shock(width);
+    std::vector<double> current(width);
+    for (std::size_t t = 0; t < total; ++t) {
+      for (std::size_t j = 0; j < width; ++j) {
+        shock[j] = sigma_eps * detail::counter_normal(streams[j], t);
+        current[j] = shock[j];
+      }
+      for (std::size_t i = 0; i < p_order; ++i) {
+        const double coeff = phi[i];
+        const double* lagged = &x_hist[((x_head + i) % p_order) * width];
+        for (std::size_t j = 0; j < width; ++j) current[j] += coeff * lagged[j];
+      }
+      for (std::size_t i = 0; i < q_order; ++i) {
+        const double coeff = theta[i];
+        const double* lagged = &e_hist[((e_head + i) % q_order) * width];
+        for (std::size_t j = 0; j < width; ++j) current[j] += coeff * lagged[j];
+      }
+      if (p_order > 0) {
+        x_head = (x_head + p_order - 1) % p_order;
+        std::copy(current.begin(), current.end(), x_hist.begin() + static_cast<std::ptrdiff_t>(x_head * width));
+      }
+      if (q_order > 0) {
+        e_head = (e_head + q_order - 1) % q_order;
+        std::copy(shock.begin(), shock.end(), e_hist.begin() + static_cast<std::ptrdiff_t>(e_head * width));
+      }
+      if (t >= burnin) {
+        double* row = df.data_[t - burnin].data() + begin;
+        for (std::size_t j = 0; j < width; ++j) row[j] = mu + current[j];
+      }
+    }
+  }, 64);
+
+  return df;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::simulate_garch_paths(std::size_t steps,
+                                                          std::size_t paths,
+                                                          double omega,
+                                                          double alpha,
+                                                          double beta,
+                                                          double mu,
+                                                          std::size_t burnin,
+                                                          std::uint64_t seed) {
+  if (!(omega > 0.0) || !(alpha >= 0.0) || !(beta >= 0.0)) {
+    throw std::runtime_error("simulate_garch_paths: need omega > 0 and alpha, beta >= 0");
+  }
+  if (!(alpha + beta < 1.0)) {
+    throw std::runtime_error("simulate_garch_paths: alpha + beta must be < 1");
+  }
+  DataFrame<IndexT> df = make_path_frame(steps, paths, "simulate_garch_paths");
+  const std::uint64_t base_seed = detail::resolve_seed(seed);
+  const double long_run_var = omega / (1.0 - alpha - beta);
+  const std::size_t total = burnin + steps;
+
+  detail::parallel_for(paths, [&](std::size_t begin, std::size_t end) {
+    const std::size_t width = end - begin;
+    std::vector<std::uint64_t> streams(width);
+    for (std::size_t j = 0; j < width; ++j) {
+      streams[j] = detail::splitmix64(base_seed ^ detail::splitmix64(begin + j));
+    }
+    // Paths start at the unconditional variance.
+    std::vector<double> variance(width, long_run_var);
+    std::vector<double> prev_sq(width, long_run_var);
+    for (std::size_t t = 0; t < total; ++t) {
+      double* row = (t >= burnin) ? df.data_[t - burnin].data() + begin : nullptr;
+      for (std::size_t j = 0; j < width; ++j) {
+        variance[j] = omega + alpha * prev_sq[j] + beta * variance[j];
+        const double dev = std::sqrt(variance[j]) * detail::counter_normal(streams[j], t);
+        prev_sq[j] = dev * dev;
+        if (row) row[j] = mu + dev;
+      }
+    }
+  }, 64);
+
+  return df;
+}
+
 template <typename IndexT>
 DataFrame<IndexT> DataFrame<IndexT>::differences() const {
   if (data_.size() < 2) {
     throw std::runtime_error("dataframe::differences: need at least two rows");
   }
-  DataFrame<IndexT> out;
-  out.columns_ = columns_;
-  out.index_.assign(index_.begin() + 1, index_.end());
-  out.index_name_ = index_name_;
-  out.data_.resize(data_.size() - 1, std::vector<double>(columns_.size(), 0.0));
-  for (std::size_t r = 1; r < data_.size(); ++r) {
-    for (std::size_t c = 0; c < columns_.size(); ++c) {
-      out.data_[r - 1][c] = data_[r][c] - data_[r - 1][c];
-    }
-  }
-  return out;
+  return lagged_transform(1, true, [](double curr, double prev) { return curr - prev; });
 }
 
 template <typename IndexT>
@@ -718,22 +1991,12 @@ DataFrame<IndexT> DataFrame<IndexT>::log_changes() const {
   if (data_.size() < 2) {
     throw std::runtime_error("dataframe::log_changes: need at least two rows");
   }
-  DataFrame<IndexT> out;
-  out.columns_ = columns_;
-  out.index_.assign(index_.begin() + 1, index_.end());
-  out.index_name_ = index_name_;
-  out.data_.resize(data_.size() - 1, std::vector<double>(columns_.size(), 0.0));
-  for (std::size_t r = 1; r < data_.size(); ++r) {
-    for (std::size_t c = 0; c < columns_.size(); ++c) {
-      double prev = data_[r - 1][c];
-      double curr = data_[r][c];
-      if (!(prev > 0.0) || !(curr > 0.0)) {
-        throw std::runtime_error("dataframe::log_changes: non-positive value encountered");
-      }
-      out.data_[r - 1][c] = std::log(curr) - std::log(prev);
+  return lagged_transform(1, true, [](double curr, double prev) {
+    if (!(prev > 0.0) || !(curr > 0.0)) {
+      throw std::runtime_error("dataframe::log_changes: non-positive value encountered");
     }
-  }
-  return out;
+    return std::log(curr) - std::log(prev);
+  });
 }
 
 template <typename IndexT>
@@ -741,24 +2004,204 @@ DataFrame<IndexT> DataFrame<IndexT>::proportional_changes() const {
   if (data_.size() < 2) {
     throw std::runtime_error("dataframe::proportional_changes: need at least two rows");
   }
+  return lagged_transform(1, true, [](double curr, double prev) {
+    if (prev == 0.0) {
+      throw std::runtime_error("dataframe::proportional_changes: zero value encountered");
+    }
+    return (curr - prev) / prev;
+  });
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::shift(long long periods) const {
+  return lagged_transform(periods, false, [](double, double prev) { return prev; });
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::diff(long long periods) const {
+  return lagged_transform(periods, false, detail::DifferenceChange{});
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::pct_change(long long periods) const {
+  return lagged_transform(periods, false, detail::ProportionalChange{"pct_change"});
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::log_change(long long periods) const {
+  return lagged_transform(periods, false, detail::LogChange{"log_change"});
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::multi_lag_changes(const std::vector<long long>& lags,
+                                                       ChangeKind kind) const {
+  if (lags.empty()) {
+    throw std::runtime_error("dataframe::multi_lag_changes: no lags given");
+  }
+  const char* suffix = kind == ChangeKind::difference
+                           ? "_diff"
+                           : (kind == ChangeKind::log ? "_log" : "_pct");
   DataFrame<IndexT> out;
-  out.columns_ = columns_;
-  out.index_.assign(index_.begin() + 1, index_.end());
+  out.index_ = index_;
   out.index_name_ = index_name_;
-  out.data_.resize(data_.size() - 1, std::vector<double>(columns_.size(), 0.0));
-  for (std::size_t r = 1; r < data_.size(); ++r) {
-    for (std::size_t c = 0; c < columns_.size(); ++c) {
-      double prev = data_[r - 1][c];
-      double curr = data_[r][c];
-      if (prev == 0.0) {
-        throw std::runtime_error("dataframe::proportional_changes: zero value encountered");
-      }
-      out.data_[r - 1][c] = (curr - prev) / prev;
+  out.columns_.reserve(lags.size() * cols());
+  for (long long lag : lags) {
+    for (const auto& name : columns_) {
+      out.columns_.push_back(name + suffix + std::to_string(lag));
     }
   }
+  out.data_.assign(rows(), std::vector<double>(out.columns_.size(), 0.0));
+
+  // One fused pass: each output row reads the current row once and every
+  // lagged row it needs, writing lag-major column blocks. The per-cell
+  // formulas are the ones diff, pct_change and log_change use, so the result
+  // and the errors for bad bases match theirs.
+  const long long row_count = static_cast<long long>(rows());
+  const std::size_t k = cols();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  auto fused = [&](auto change) {
+    detail::parallel_for(rows(), [&](std::size_t begin, std::size_t end) {
+      for (std::size_t r = begin; r < end; ++r) {
+        const std::vector<double>& current = data_[r];
+        double* dest = out.data_[r].data();
+        for (std::size_t l = 0; l < lags.size(); ++l, dest += k) {
+          const long long source = static_cast<long long>(r) - lags[l];
+          if (source < 0 || source >= row_count) {
+            std::fill(dest, dest + k, nan);
+            continue;
+          }
+          const std::vector<double>& lagged = data_[static_cast<std::size_t>(source)];
+          for (std::size_t c = 0; c < k; ++c) dest[c] = change(current[c], lagged[c]);
+        }
+      }
+    }, 4096);
+  };
+  if (kind == ChangeKind::difference) {
+    fused(detail::DifferenceChange{});
+  } else if (kind == ChangeKind::proportional) {
+    fused(detail::ProportionalChange{"multi_lag_changes"});
+  } else {
+    fused(detail::LogChange{"multi_lag_changes"});
+  }
+
   return out;
 }
 
+// Fills each NaN with the last valid value above it; limit caps how many
+// consecutive NaNs are filled (0 means no cap).
+template <typename IndexT>
+void DataFrame<IndexT>::ffill(std::size_t limit) {
+  const std::size_t k = cols();
+  std::vector<double> last(k, std::numeric_limits<double>::quiet_NaN());
+  std::vector<std::size_t> run(k, 0);
+  for (auto& row : data_) {
+    for (std::size_t c = 0; c < k; ++c) {
+      double& v = row[c];
+      if (v == v) {
+        last[c] = v;
+        run[c] = 0;
+      } else if (last[c] == last[c] && (limit == 0 || run[c] < limit)) {
+        v = last[c];
+        ++run[c];
+      }
+    }
+  }
+}
+
+// Fills each NaN with the next valid value below it; limit as for ffill.
+template <typename IndexT>
+void DataFrame<IndexT>::bfill(std::size_t limit) {
+  const std::size_t k = cols();
+  std::vector<double> next(k, std::numeric_limits<double>::quiet_NaN());
+  std::vector<std::size_t> run(k, 0);
+  for (auto row = data_.rbegin(); row != data_.rend(); ++row) {
+    for (std::size_t c = 0; c < k; ++c) {
+      double& v = (*row)[c];
+      if (v == v) {
+        next[c] = v;
+        run[c] = 0;
+      } else if (next[c] == next[c] && (limit == 0 || run[c] < limit)) {
+        v = next[c];
+        ++run[c];
+      }
+    }
+  }
+}
+
+// Linearly interpolates interior NaN runs between the valid values around them.
+// Date and DateTime indices weight by elapsed time; other indices by row
+// position. Leading and trailing NaNs are left as they are. Each gap is filled
+// once its closing value is reached, so the frame is walked a single time.
+template <typename IndexT>
+void DataFrame<IndexT>::interpolate() {
+  auto coordinate = [this](std::size_t r) -> double {
+    if constexpr (std::is_same_v<IndexT, Date>) {
+      return static_cast<double>(days_since_epoch(index_[r]));
+    } else if constexpr (std::is_same_v<IndexT, DateTime>) {
+      return static_cast<double>(seconds_since_epoch(index_[r]));
+    } else {
+      return static_cast<double>(r);
+    }
+  };
+
+  const std::size_t k = cols();
+  constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+  std::vector<std::size_t> last(k, none);
+  for (std::size_t r = 0; r < data_.size(); ++r) {
+    for (std::size_t c = 0; c < k; ++c) {
+      const double v = data_[r][c];
+      if (!(v == v)) continue;
+      const std::size_t p = last[c];
+      if (p != none && r - p > 1) {
+        const double x0 = coordinate(p);
+        const double span = coordinate(r) - x0;
+        const double y0 = data_[p][c];
+        const double slope = (span != 0.0) ? (v - y0) / span : 0.0;
+        for (std::size_t g = p + 1; g < r; ++g) {
+          data_[g][c] = y0 + slope * (coordinate(g) - x0);
+        }
+      }
+      last[c] = r;
+    }
+  }
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::cumsum() const {
+  auto identity = [](double v) { return v; };
+  return cumulative_scan([](double a, double b) { return a + b; }, identity, identity);
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::cumprod() const {
+  auto identity = [](double v) { return v; };
+  return cumulative_scan([](double a, double b) { return a * b; }, identity, identity);
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::cummax() const {
+  auto identity = [](double v) { return v; };
+  return cumulative_scan([](double a, double b) { return std::max(a, b); }, identity, identity);
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::cummin() const {
+  auto identity = [](double v) { return v; };
+  return cumulative_scan([](double a, double b) { return std::min(a, b); }, identity, identity);
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::wealth_index(bool log_returns, double initial) const {
+  if (log_returns) {
+    return cumulative_scan([](double a, double b) { return a + b; },
+                           [](double v) { return v; },
+                           [initial](double v) { return initial * std::exp(v); });
+  }
+  return cumulative_scan([](double a, double b) { return a * b; },
+                         [](double v) { return 1.0 + v; },
+                         [initial](double v) { return initial * v; });
+}
+
 template <typename IndexT>
 DataFrame<std::string> DataFrame<IndexT>::column_stats_dataframe() const {
   static const std::vector<std::string> labels = {"n",       "median", "mean",
@@ -801,19 +2244,7 @@ DataFrame<std::string> DataFrame<IndexT>::correlation_matrix() const {
   if (rows() < 2) {
     throw std::runtime_error("dataframe::correlation_matrix: need at least two rows");
   }
-  std::vector<std::size_t> valid_rows;
-  valid_rows.reserve(rows());
-  for (std::size_t r = 0; r < rows(); ++r) {
-    bool has_nan = false;
-    for (std::size_t c = 0; c < cols(); ++c) {
-      const double v = data_[r][c];
-      if (!(v == v)) {
-        has_nan = true;
-        break;
-      }
-    }
-    if (!has_nan) valid_rows.push_back(r);
-  }
+  std::vector<std::size_t> valid_rows = complete_row_positions();
   if (valid_rows.size() < 2) {
     throw std::runtime_error("dataframe::correlation_matrix: need at least two non-NaN rows");
   }
@@ -821,24 +2252,33 @@ DataFrame<std::string> DataFrame<IndexT>::correlation_matrix() const {
   out.columns_ = columns_;
   out.index_ = columns_;
   out.index_name_ = "column";
-  out.data_.assign(columns_.size(), std::vector<double>(columns_.size(), 0.0));
+  correlations_over_positions(valid_rows, out.data_);
+  return out;
+}
+
+template <typename IndexT>
+void DataFrame<IndexT>::correlations_over_positions(
+    const std::vector<std::size_t>& positions,
+    std::vector<std::vector<double>>& out) const {
+  out.assign(columns_.size(), std::vector<double>(columns_.size(), 0.0));
+  const double count = static_cast<double>(positions.size());
 
   std::vector<double> means(columns_.size(), 0.0);
   for (std::size_t c = 0; c < columns_.size(); ++c) {
-    for (std::size_t r_index : valid_rows) {
+    for (std::size_t r_index : positions) {
       means[c] += data_[r_index][c];
     }
-    means[c] /= static_cast<double>(valid_rows.size());
+    means[c] /= count;
   }
 
   std::vector<double> sds(columns_.size(), 0.0);
   for (std::size_t c = 0; c < columns_.size(); ++c) {
     double accum = 0.0;
-    for (std::size_t r_index : valid_rows) {
+    for (std::size_t r_index : positions) {
       double diff = data_[r_index][c] - means[c];
       accum += diff * diff;
     }
-    const double var = accum / static_cast<double>(valid_rows.size() - 1);
+    const double var = accum / (count - 1.0);
     sds[c] = (var > 0.0) ? std::sqrt(var) : 0.0;
   }
 
@@ -846,23 +2286,21 @@ DataFrame<std::string> DataFrame<IndexT>::correlation_matrix() const {
   for (std::size_t i = 0; i < columns_.size(); ++i) {
     for (std::size_t j = 0; j < columns_.size(); ++j) {
       if (i == j) {
-        out.data_[i][j] = 1.0;
+        out[i][j] = 1.0;
         continue;
       }
       double accum = 0.0;
-      for (std::size_t r_index : valid_rows) {
+      for (std::size_t r_index : positions) {
         accum += (data_[r_index][i] - means[i]) * (data_[r_index][j] - means[j]);
       }
-      const double cov = accum / static_cast<double>(valid_rows.size() - 1);
+      const double cov = accum / (count - 1.0);
       if (sds[i] <= 0.0 || sds[j] <= 0.0) {
-        out.data_[i][j] = nan;
+        out[i][j] = nan;
       } else {
-        out.data_[i][j] = cov / (sds[i] * sds[j]);
+        out[i][j] = cov / (sds[i] * sds[j]);
       }
     }
   }
-
-  return out;
 }
 
 template <typename IndexT>
@@ -999,91 +2437,615 @@ DataFrame<std::string> DataFrame<IndexT>::column_percentiles(
   out.columns_ = columns_;
   out.data_.assign(percentiles.size(), std::vector<double>(columns_.size(), 0.0));
 
-  for (std::size_t c = 0; c < cols(); ++c) {
-    std::vector<double> values;
-    values.reserve(rows());
-    for (std::size_t r = 0; r < rows(); ++r) {
-      double v = data_[r][c];
-      if (v == v) values.push_back(v);
+  for (std::size_t c = 0; c < cols(); ++c) {
+    std::vector<double> values;
+    values.reserve(rows());
+    for (std::size_t r = 0; r < rows(); ++r) {
+      double v = data_[r][c];
+      if (v == v) values.push_back(v);
+    }
+    if (values.empty()) {
+      for (std::size_t p_idx = 0; p_idx < percentiles.size(); ++p_idx) {
+        out.data_[p_idx][c] = std::numeric_limits<double>::quiet_NaN();
+      }
+      continue;
+    }
+    std::sort(values.begin(), values.end());
+    for (std::size_t p_idx = 0; p_idx < percentiles.size(); ++p_idx) {
+      out.data_[p_idx][c] = detail::sorted_percentile(values, percentiles[p_idx]);
+    }
+  }
+
+  return out;
+}
+
+template <typename IndexT>
+DataFrame<std::string> DataFrame<IndexT>::covariance_matrix() const {
+  if (columns_.empty()) {
+    throw std::runtime_error("dataframe::covariance_matrix: no columns");
+  }
+  if (rows() < 2) {
+    throw std::runtime_error("dataframe::covariance_matrix: need at least two rows");
+  }
+  std::vector<std::size_t> valid_rows = complete_row_positions();
+  if (valid_rows.size() < 2) {
+    throw std::runtime_error("dataframe::covariance_matrix: need at least two non-NaN rows");
+  }
+
+  DataFrame<std::string> out;
+  out.columns_ = columns_;
+  out.index_ = columns_;
+  out.index_name_ = "column";
+  out.data_.assign(columns_.size(), std::vector<double>(columns_.size(), 0.0));
+
+  std::vector<double> means(columns_.size(), 0.0);
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    for (std::size_t r_index : valid_rows) {
+      means[c] += data_[r_index][c];
+    }
+    means[c] /= static_cast<double>(valid_rows.size());
+  }
+
+  std::vector<std::size_t> column_ids(columns_.size());
+  std::iota(column_ids.begin(), column_ids.end(), std::size_t{0});
+  std::vector<double> cross;
+  cross_products_over_positions(valid_rows, column_ids, means, cross);
+  const std::size_t k = columns_.size();
+  for (std::size_t i = 0; i < k; ++i) {
+    for (std::size_t j = 0; j < k; ++j) {
+      out.data_[i][j] = cross[i * k + j] / static_cast<double>(valid_rows.size() - 1);
+    }
+  }
+
+  return out;
+}
+
+// Sums of (x_i - center_i) * (x_j - center_j) over the given rows for every
+// pair of the selected columns, as a row-major k x k matrix, via syrk on a
+// centered view of the rows. A column subset other than 0..cols()-1 is first
+// gathered into a compact matrix.
+template <typename IndexT>
+void DataFrame<IndexT>::cross_products_over_positions(const std::vector<std::size_t>& positions,
+                                                      const std::vector<std::size_t>& column_ids,
+                                                      const std::vector<double>& centers,
+                                                      std::vector<double>& out) const {
+  const std::size_t k = column_ids.size();
+  bool all_columns = (k == cols());
+  for (std::size_t c = 0; all_columns && c < k; ++c) all_columns = (column_ids[c] == c);
+  if (all_columns) {
+    out = syrk(rows_view(positions).centered(centers.data())).values;
+    return;
+  }
+  Matrix gathered(positions.size(), k);
+  for (std::size_t i = 0; i < positions.size(); ++i) {
+    const std::vector<double>& row = data_[positions[i]];
+    for (std::size_t c = 0; c < k; ++c) gathered(i, c) = row[column_ids[c]];
+  }
+  out = syrk(gathered.view().centered(centers.data())).values;
+}
+
+template <typename IndexT>
+MatrixView DataFrame<IndexT>::rows_view(const std::vector<std::size_t>& positions) const {
+  std::vector<const double*> pointers(positions.size());
+  for (std::size_t i = 0; i < positions.size(); ++i) pointers[i] = data_[positions[i]].data();
+  return MatrixView(std::move(pointers), cols());
+}
+
+template <typename IndexT>
+MatrixView DataFrame<IndexT>::matrix_view() const {
+  std::vector<const double*> pointers(rows());
+  for (std::size_t r = 0; r < rows(); ++r) pointers[r] = data_[r].data();
+  return MatrixView(std::move(pointers), cols());
+}
+
+// Matrix product with a frame whose rows line up with this frame's columns
+// (e.g. loadings or a weight matrix); the result keeps this frame's index and
+// takes the other frame's column names. A string-indexed other frame must be
+// labelled with this frame's column names in the same order; any other index
+// type is matched by position.
+template <typename IndexT>
+template <typename OtherIndexT>
+DataFrame<IndexT> DataFrame<IndexT>::matmul(const DataFrame<OtherIndexT>& other) const {
+  if (other.rows() != cols()) {
+    throw std::runtime_error("dataframe::matmul: other frame must have one row per column");
+  }
+  if constexpr (std::is_same_v<OtherIndexT, std::string>) {
+    if (other.index() != columns_) {
+      throw std::runtime_error("dataframe::matmul: other frame's index labels must match the column names");
+    }
+  }
+  const Matrix product = gemm(matrix_view(), other.matrix_view());
+  DataFrame<IndexT> out;
+  out.columns_ = other.columns();
+  out.index_ = index_;
+  out.index_name_ = index_name_;
+  out.data_.resize(rows());
+  for (std::size_t r = 0; r < rows(); ++r) {
+    out.data_[r].assign(product.row(r), product.row(r) + product.cols);
+  }
+  return out;
+}
+
+// Weighted sum across columns for every row, e.g. portfolio returns.
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::dot(const std::vector<double>& weights,
+                                         const std::string& name) const {
+  if (weights.size() != cols()) {
+    throw std::runtime_error("dataframe::dot: weight count mismatch");
+  }
+  const std::vector<double> values = gemv(matrix_view(), weights);
+  DataFrame<IndexT> out;
+  out.columns_ = {name};
+  out.index_ = index_;
+  out.index_name_ = index_name_;
+  out.data_.resize(rows());
+  for (std::size_t r = 0; r < rows(); ++r) out.data_[r] = {values[r]};
+  return out;
+}
+
+// Least squares of y on an intercept and x_columns over rows where all of them
+// are present. The centered cross products come from the covariance kernel and
+// are solved with a Cholesky factorization.
+template <typename IndexT>
+OlsFit<IndexT> DataFrame<IndexT>::ols(const std::string& y_column,
+                                      const std::vector<std::string>& x_columns) const {
+  if (x_columns.empty()) {
+    throw std::runtime_error("dataframe::ols: no regressors given");
+  }
+  const std::size_t k = x_columns.size();
+  std::vector<std::size_t> ids;
+  ids.reserve(k + 1);
+  for (const auto& name : x_columns) ids.push_back(find_column_index(name));
+  ids.push_back(find_column_index(y_column));
+
+  std::vector<std::size_t> positions;
+  positions.reserve(rows());
+  for (std::size_t r = 0; r < rows(); ++r) {
+    bool complete = true;
+    for (std::size_t id : ids) {
+      const double v = data_[r][id];
+      if (!(v == v)) {
+        complete = false;
+        break;
+      }
+    }
+    if (complete) positions.push_back(r);
+  }
+  const std::size_t n = positions.size();
+  if (n <= k + 1) {
+    throw std::runtime_error("dataframe::ols: need more complete rows than coefficients");
+  }
+
+  std::vector<double> means(k + 1, 0.0);
+  for (std::size_t r_index : positions) {
+    for (std::size_t c = 0; c <= k; ++c) means[c] += data_[r_index][ids[c]];
+  }
+  for (double& m : means) m /= static_cast<double>(n);
+
+  std::vector<double> cross;
+  cross_products_over_positions(positions, ids, means, cross);
+  std::vector<double> sxx(k * k);
+  std::vector<double> beta(k);
+  for (std::size_t i = 0; i < k; ++i) {
+    for (std::size_t j = 0; j < k; ++j) sxx[i * k + j] = cross[i * (k + 1) + j];
+    beta[i] = cross[i * (k + 1) + k];
+  }
+  const double syy = cross[k * (k + 1) + k];
+  if (!stats::cholesky_decompose(sxx, k)) {
+    throw std::runtime_error("dataframe::ols: regressors are collinear or constant");
+  }
+  stats::cholesky_solve(sxx, k, beta);
+  double intercept = means[k];
+  for (std::size_t i = 0; i < k; ++i) intercept -= beta[i] * means[i];
+
+  OlsFit<IndexT> fit;
+  fit.n = n;
+  fit.residuals.columns_ = {"residual"};
+  fit.residuals.index_ = index_;
+  fit.residuals.index_name_ = index_name_;
+  fit.residuals.data_.assign(rows(), std::vector<double>(1, std::numeric_limits<double>::quiet_NaN()));
+  double rss = 0.0;
+  for (std::size_t r_index : positions) {
+    const std::vector<double>& row = data_[r_index];
+    double fitted = intercept;
+    for (std::size_t i = 0; i < k; ++i) fitted += beta[i] * row[ids[i]];
+    const double e = row[ids[k]] - fitted;
+    fit.residuals.data_[r_index][0] = e;
+    rss += e * e;
+  }
+  const double s2 = rss / static_cast<double>(n - k - 1);
+  fit.residual_sd = std::sqrt(s2);
+  fit.r_squared = (syy > 0.0) ? 1.0 - rss / syy : std::numeric_limits<double>::quiet_NaN();
+
+  // Var(intercept) = s2 * (1/n + xbar' Sxx^-1 xbar).
+  std::vector<double> inverse_diag = stats::cholesky_inverse_diagonal(sxx, k);
+  std::vector<double> x_means(means.begin(), means.begin() + static_cast<std::ptrdiff_t>(k));
+  std::vector<double> solved = x_means;
+  stats::cholesky_solve(sxx, k, solved);
+  double leverage = 1.0 / static_cast<double>(n);
+  for (std::size_t i = 0; i < k; ++i) leverage += x_means[i] * solved[i];
+
+  fit.coefficients.columns_ = {"coefficient", "std_error", "t_stat"};
+  fit.coefficients.index_name_ = "term";
+  fit.coefficients.index_.push_back("intercept");
+  const double intercept_se = std::sqrt(s2 * leverage);
+  fit.coefficients.data_.push_back({intercept, intercept_se, intercept / intercept_se});
+  for (std::size_t i = 0; i < k; ++i) {
+    const double se = std::sqrt(s2 * inverse_diag[i]);
+    fit.coefficients.index_.push_back(x_columns[i]);
+    fit.coefficients.data_.push_back({beta[i], se, beta[i] / se});
+  }
+  return fit;
+}
+
+// Principal components of the sample covariance (or correlation) matrix over
+// complete rows, from a symmetric eigen-decomposition; n_components == 0 keeps
+// them all. Each loading vector is signed so its largest entry is positive.
+template <typename IndexT>
+PcaResult<IndexT> DataFrame<IndexT>::pca(std::size_t n_components, bool use_correlation) const {
+  const std::size_t k = cols();
+  if (k == 0) {
+    throw std::runtime_error("dataframe::pca: no columns");
+  }
+  if (n_components == 0) n_components = k;
+  if (n_components > k) {
+    throw std::runtime_error("dataframe::pca: n_components exceeds column count");
+  }
+  const std::vector<std::size_t> valid_rows = complete_row_positions();
+  if (valid_rows.size() < 2) {
+    throw std::runtime_error("dataframe::pca: need at least two non-NaN rows");
+  }
+
+  std::vector<double> means(k, 0.0);
+  for (std::size_t r_index : valid_rows) {
+    for (std::size_t c = 0; c < k; ++c) means[c] += data_[r_index][c];
+  }
+  for (double& m : means) m /= static_cast<double>(valid_rows.size());
+  std::vector<std::size_t> column_ids(k);
+  std::iota(column_ids.begin(), column_ids.end(), std::size_t{0});
+  std::vector<double> cov;
+  cross_products_over_positions(valid_rows, column_ids, means, cov);
+  for (double& v : cov) v /= static_cast<double>(valid_rows.size() - 1);
+
+  std::vector<double> scales(k, 1.0);
+  if (use_correlation) {
+    for (std::size_t c = 0; c < k; ++c) {
+      const double var = cov[c * k + c];
+      if (!(var > 0.0)) {
+        throw std::runtime_error("dataframe::pca: constant column cannot be standardized");
+      }
+      scales[c] = 1.0 / std::sqrt(var);
+    }
+    for (std::size_t i = 0; i < k; ++i) {
+      for (std::size_t j = 0; j < k; ++j) cov[i * k + j] *= scales[i] * scales[j];
+    }
+  }
+
+  const stats::SymmetricEigen eigen = stats::symmetric_eigen(cov, k);
+  double total = 0.0;
+  for (double v : eigen.values) total += std::max(v, 0.0);
+
+  PcaResult<IndexT> result;
+  std::vector<std::string> names(n_components);
+  for (std::size_t j = 0; j < n_components; ++j) names[j] = "pc" + std::to_string(j + 1);
+
+  result.loadings.columns_ = names;
+  result.loadings.index_ = columns_;
+  result.loadings.index_name_ = "column";
+  result.loadings.data_.assign(k, std::vector<double>(n_components, 0.0));
+  for (std::size_t j = 0; j < n_components; ++j) {
+    for (std::size_t c = 0; c < k; ++c) result.loadings.data_[c][j] = eigen.vectors[j * k + c];
+  }
+
+  result.explained_variance.columns_ = {"variance", "ratio", "cumulative_ratio"};
+  result.explained_variance.index_ = names;
+  result.explained_variance.index_name_ = "component";
+  double cumulative = 0.0;
+  for (std::size_t j = 0; j < n_components; ++j) {
+    const double ratio = total > 0.0 ? std::max(eigen.values[j], 0.0) / total
+                                     : std::numeric_limits<double>::quiet_NaN();
+    cumulative += ratio;
+    result.explained_variance.data_.push_back({eigen.values[j], ratio, cumulative});
+  }
+
+  result.scores.columns_ = names;
+  result.scores.index_ = index_;
+  result.scores.index_name_ = index_name_;
+  result.scores.data_.assign(rows(), std::vector<double>(n_components,
+                                                         std::numeric_limits<double>::quiet_NaN()));
+  Matrix weights(k, n_components);
+  for (std::size_t c = 0; c < k; ++c) {
+    for (std::size_t j = 0; j < n_components; ++j) {
+      weights(c, j) = scales[c] * eigen.vectors[j * k + c];
+    }
+  }
+  const Matrix projected = gemm(rows_view(valid_rows).centered(means.data()), weights.view());
+  for (std::size_t i = 0; i < valid_rows.size(); ++i) {
+    result.scores.data_[valid_rows[i]].assign(projected.row(i), projected.row(i) + n_components);
+  }
+  return result;
+}
+
+// OLS over each trailing window of rows; row t of the result (one per window,
+// indexed like rolling_mean) holds the intercept and slopes, their t-stats,
+// and the residual of row t. The uncentered cross products of [1, x, y] are
+// kept up to date with O(k^2) add/remove updates as the window slides and
+// rebuilt from scratch once per window to bound drift. Rows missing any of
+// the columns are left out of the window; windows with too few rows or a
+// singular design are NaN. Row ranges are processed in parallel, each one
+// seeding its own window.
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::rolling_ols(const std::string& y_column,
+                                                 const std::vector<std::string>& x_columns,
+                                                 std::size_t window) const {
+  if (x_columns.empty()) {
+    throw std::runtime_error("dataframe::rolling_ols: no regressors given");
+  }
+  if (window == 0) {
+    throw std::runtime_error("dataframe::rolling_ols: window must be positive");
+  }
+  if (window > rows()) {
+    throw std::runtime_error("dataframe::rolling_ols: window exceeds row count");
+  }
+  const std::size_t k = x_columns.size();
+  const std::size_t p = k + 1;   // coefficients
+  const std::size_t m = k + 2;   // [1, x..., y]
+  std::vector<std::size_t> ids;
+  for (const auto& name : x_columns) ids.push_back(find_column_index(name));
+  ids.push_back(find_column_index(y_column));
+
+  DataFrame<IndexT> out;
+  out.columns_.push_back("intercept");
+  out.columns_.insert(out.columns_.end(), x_columns.begin(), x_columns.end());
+  out.columns_.push_back("t_intercept");
+  for (const auto& name : x_columns) out.columns_.push_back("t_" + name);
+  out.columns_.push_back("residual");
+  out.index_name_ = index_name_;
+  out.index_.assign(index_.begin() + static_cast<std::ptrdiff_t>(window - 1), index_.end());
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  out.data_.assign(rows() - window + 1, std::vector<double>(out.columns_.size(), nan));
+
+  auto load = [&](std::size_t r, double* z) {
+    z[0] = 1.0;
+    for (std::size_t c = 0; c <= k; ++c) {
+      const double v = data_[r][ids[c]];
+      if (!(v == v)) return false;
+      z[c + 1] = v;
     }
-    if (values.empty()) {
-      for (std::size_t p_idx = 0; p_idx < percentiles.size(); ++p_idx) {
-        out.data_[p_idx][c] = std::numeric_limits<double>::quiet_NaN();
+    return true;
+  };
+
+  detail::parallel_for(out.data_.size(), [&](std::size_t begin, std::size_t end) {
+    std::vector<double> zz(m * m, 0.0);
+    std::vector<double> z(m);
+    std::vector<double> a(p * p);
+    std::vector<double> b(p);
+    std::size_t count = 0;
+    auto accumulate = [&](std::size_t r, double sign) {
+      if (!load(r, z.data())) return;
+      for (std::size_t i = 0; i < m; ++i) {
+        const double zi = sign * z[i];
+        for (std::size_t j = i; j < m; ++j) zz[i * m + j] += zi * z[j];
       }
-      continue;
-    }
-    std::sort(values.begin(), values.end());
-    for (std::size_t p_idx = 0; p_idx < percentiles.size(); ++p_idx) {
-      double percentile = percentiles[p_idx];
-      if (percentile <= 0.0) {
-        out.data_[p_idx][c] = values.front();
-        continue;
+      count = sign > 0.0 ? count + 1 : count - 1;
+    };
+
+    for (std::size_t o = begin; o < end; ++o) {
+      const std::size_t last = o + window - 1;  // source row of this output row
+      if (o == begin || (o - begin) % window == 0) {
+        std::fill(zz.begin(), zz.end(), 0.0);
+        count = 0;
+        for (std::size_t r = o; r <= last; ++r) accumulate(r, 1.0);
+      } else {
+        accumulate(last, 1.0);
+        accumulate(o - 1, -1.0);
       }
-      if (percentile >= 100.0) {
-        out.data_[p_idx][c] = values.back();
-        continue;
+      if (count <= p) continue;
+
+      for (std::size_t i = 0; i < p; ++i) {
+        for (std::size_t j = 0; j < p; ++j) {
+          a[i * p + j] = (i <= j) ? zz[i * m + j] : zz[j * m + i];
+        }
+        b[i] = zz[i * m + p];
       }
-      double rank = (percentile / 100.0) * static_cast<double>(values.size() - 1);
-      std::size_t lower = static_cast<std::size_t>(std::floor(rank));
-      std::size_t upper = static_cast<std::size_t>(std::ceil(rank));
-      double fraction = rank - static_cast<double>(lower);
-      const double lower_value = values[lower];
-      const double upper_value = values[upper];
-      out.data_[p_idx][c] = lower_value + fraction * (upper_value - lower_value);
-    }
-  }
+      if (!stats::cholesky_decompose(a, p)) continue;
+      stats::cholesky_solve(a, p, b);
+      double rss = zz[p * m + p];
+      for (std::size_t i = 0; i < p; ++i) rss -= b[i] * zz[i * m + p];
+      const double s2 = std::max(rss, 0.0) / static_cast<double>(count - p);
+      const std::vector<double> inverse_diag = stats::cholesky_inverse_diagonal(a, p);
 
+      std::vector<double>& dest = out.data_[o];
+      for (std::size_t i = 0; i < p; ++i) {
+        dest[i] = b[i];
+        dest[p + i] = b[i] / std::sqrt(s2 * inverse_diag[i]);
+      }
+      if (load(last, z.data())) {
+        double fitted = 0.0;
+        for (std::size_t i = 0; i < p; ++i) fitted += b[i] * z[i];
+        dest[2 * p] = z[p] - fitted;
+      }
+    }
+  }, 256);
   return out;
 }
 
+// Ledoit-Wolf shrinkage of the complete-row sample covariance. The sample
+// covariance and the fourth-moment sums the optimal intensity needs are
+// gathered in one pass over the centered rows. Intensities follow the papers'
+// 1/n moments; the returned matrix keeps covariance_matrix's n-1 scaling.
 template <typename IndexT>
-DataFrame<std::string> DataFrame<IndexT>::covariance_matrix() const {
+ShrunkCovariance DataFrame<IndexT>::shrunk_covariance_matrix(ShrinkageTarget target) const {
   if (columns_.empty()) {
-    throw std::runtime_error("dataframe::covariance_matrix: no columns");
+    throw std::runtime_error("dataframe::shrunk_covariance_matrix: no columns");
   }
-  if (rows() < 2) {
-    throw std::runtime_error("dataframe::covariance_matrix: need at least two rows");
+  const std::vector<std::size_t> valid_rows = complete_row_positions();
+  if (valid_rows.size() < 2) {
+    throw std::runtime_error("dataframe::shrunk_covariance_matrix: need at least two non-NaN rows");
   }
-  std::vector<std::size_t> valid_rows;
-  valid_rows.reserve(rows());
-  for (std::size_t r = 0; r < rows(); ++r) {
-    bool has_nan = false;
-    for (std::size_t c = 0; c < cols(); ++c) {
-      const double v = data_[r][c];
-      if (!(v == v)) {
-        has_nan = true;
-        break;
+  const std::size_t k = cols();
+  const double n = static_cast<double>(valid_rows.size());
+  std::vector<double> means(k, 0.0);
+  for (std::size_t r_index : valid_rows) {
+    for (std::size_t c = 0; c < k; ++c) means[c] += data_[r_index][c];
+  }
+  for (double& m : means) m /= n;
+
+  std::vector<double> sample, squares, cubes;
+  shrinkage_moments_over_positions(valid_rows, means, sample, squares, cubes);
+  for (double& v : sample) v /= n;
+
+  std::vector<double> prior(k * k, 0.0);
+  double shrinkage = 0.0;
+  if (target == ShrinkageTarget::scaled_identity) {
+    double trace = 0.0;
+    double sample_norm = 0.0;
+    double fourth = 0.0;
+    for (std::size_t i = 0; i < k; ++i) trace += sample[i * k + i];
+    for (std::size_t i = 0; i < k * k; ++i) {
+      sample_norm += sample[i] * sample[i];
+      fourth += squares[i];
+    }
+    const double p = static_cast<double>(k);
+    const double mu = trace / p;
+    const double delta = (sample_norm - p * mu * mu) / p;
+    const double beta_bar = std::max(0.0, (fourth - n * sample_norm) / (n * n * p));
+    shrinkage = delta > 0.0 ? std::min(beta_bar, delta) / delta : 0.0;
+    for (std::size_t i = 0; i < k; ++i) prior[i * k + i] = mu;
+  } else {
+    std::vector<double> sd(k);
+    for (std::size_t i = 0; i < k; ++i) {
+      if (!(sample[i * k + i] > 0.0)) {
+        throw std::runtime_error("dataframe::shrunk_covariance_matrix: constant column");
       }
+      sd[i] = std::sqrt(sample[i * k + i]);
     }
-    if (!has_nan) valid_rows.push_back(r);
-  }
-  if (valid_rows.size() < 2) {
-    throw std::runtime_error("dataframe::covariance_matrix: need at least two non-NaN rows");
+    double mean_corr = 0.0;
+    for (std::size_t i = 0; i < k; ++i) {
+      for (std::size_t j = i + 1; j < k; ++j) mean_corr += sample[i * k + j] / (sd[i] * sd[j]);
+    }
+    if (k > 1) mean_corr /= 0.5 * static_cast<double>(k * (k - 1));
+
+    double pi = 0.0;
+    double rho = 0.0;
+    double gamma = 0.0;
+    for (std::size_t i = 0; i < k; ++i) {
+      for (std::size_t j = 0; j < k; ++j) {
+        const double s_ij = sample[i * k + j];
+        const double pi_ij = squares[i * k + j] / n - s_ij * s_ij;
+        pi += pi_ij;
+        if (i == j) {
+          prior[i * k + j] = s_ij;
+          rho += pi_ij;
+          continue;
+        }
+        prior[i * k + j] = mean_corr * sd[i] * sd[j];
+        const double theta_ii = cubes[i * k + j] / n - sample[i * k + i] * s_ij;
+        const double theta_jj = cubes[j * k + i] / n - sample[j * k + j] * s_ij;
+        rho += 0.5 * mean_corr * (sd[j] / sd[i] * theta_ii + sd[i] / sd[j] * theta_jj);
+        const double gap = prior[i * k + j] - s_ij;
+        gamma += gap * gap;
+      }
+    }
+    shrinkage = gamma > 0.0 ? std::max(0.0, std::min(1.0, (pi - rho) / gamma / n)) : 0.0;
   }
 
-  DataFrame<std::string> out;
+  ShrunkCovariance result;
+  result.shrinkage = shrinkage;
+  result.target = target;
+  DataFrame<std::string>& out = result.covariance;
   out.columns_ = columns_;
   out.index_ = columns_;
   out.index_name_ = "column";
-  out.data_.assign(columns_.size(), std::vector<double>(columns_.size(), 0.0));
-
-  std::vector<double> means(columns_.size(), 0.0);
-  for (std::size_t c = 0; c < columns_.size(); ++c) {
-    for (std::size_t r_index : valid_rows) {
-      means[c] += data_[r_index][c];
+  out.data_.assign(k, std::vector<double>(k, 0.0));
+  const double unbiased = n / (n - 1.0);
+  for (std::size_t i = 0; i < k; ++i) {
+    for (std::size_t j = 0; j < k; ++j) {
+      out.data_[i][j] =
+          unbiased * (shrinkage * prior[i * k + j] + (1.0 - shrinkage) * sample[i * k + j]);
     }
-    means[c] /= static_cast<double>(valid_rows.size());
   }
+  return result;
+}
 
-  for (std::size_t i = 0; i < columns_.size(); ++i) {
-    for (std::size_t j = 0; j < columns_.size(); ++j) {
-      double accum = 0.0;
-      for (std::size_t r_index : valid_rows) {
-        accum += (data_[r_index][i] - means[i]) * (data_[r_index][j] - means[j]);
+// Single pass over centered rows accumulating, for every column pair, the
+// sums of x_i * x_j (second), x_i^2 * x_j^2 (squares) and x_i^3 * x_j (cubes).
+template <typename IndexT>
+void DataFrame<IndexT>::shrinkage_moments_over_positions(const std::vector<std::size_t>& positions,
+                                                         const std::vector<double>& centers,
+                                                         std::vector<double>& second,
+                                                         std::vector<double>& squares,
+                                                         std::vector<double>& cubes) const {
+  const std::size_t k = cols();
+  second.assign(k * k, 0.0);
+  squares.assign(k * k, 0.0);
+  cubes.assign(k * k, 0.0);
+  detail::parallel_for(k, [&](std::size_t begin, std::size_t end) {
+    std::vector<double> x(k), x2(k);
+    for (std::size_t r_index : positions) {
+      const std::vector<double>& row = data_[r_index];
+      for (std::size_t c = 0; c < k; ++c) {
+        x[c] = row[c] - centers[c];
+        x2[c] = x[c] * x[c];
+      }
+      for (std::size_t i = begin; i < end; ++i) {
+        const double xi = x[i];
+        const double xi2 = x2[i];
+        const double xi3 = xi2 * xi;
+        double* s = &second[i * k];
+        double* q = &squares[i * k];
+        double* t = &cubes[i * k];
+        for (std::size_t j = 0; j < k; ++j) t[j] += xi3 * x[j];
+        for (std::size_t j = i; j < k; ++j) {
+          s[j] += xi * x[j];
+          q[j] += xi2 * x2[j];
+        }
       }
-      out.data_[i][j] = accum / static_cast<double>(valid_rows.size() - 1);
     }
+  }, 8);
+  for (std::size_t i = 0; i < k; ++i) {
+    for (std::size_t j = 0; j < i; ++j) {
+      second[i * k + j] = second[j * k + i];
+      squares[i * k + j] = squares[j * k + i];
+    }
+  }
+}
+
+template <typename IndexT>
+DataFrame<int> DataFrame<IndexT>::autocorrelation_matrix(std::size_t max_lag) const {
+  if (max_lag == 0) {
+    throw std::runtime_error("dataframe::autocorrelation_matrix: max_lag must be positive");
+  }
+  if (max_lag > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+    throw std::runtime_error("dataframe::autocorrelation_matrix: max_lag too large");
+  }
+
+  DataFrame<int> out;
+  out.columns_ = columns_;
+  out.index_name_ = "lag";
+  out.index_.resize(max_lag);
+  for (std::size_t lag = 1; lag <= max_lag; ++lag) {
+    out.index_[lag - 1] = static_cast<int>(lag);
   }
+  out.data_.assign(max_lag, std::vector<double>(cols(), std::numeric_limits<double>::quiet_NaN()));
+
+  // Each column is independent, so columns are split across threads; lags beyond
+  // the column's non-NaN length stay NaN.
+  detail::parallel_for(cols(), [&](std::size_t begin, std::size_t end) {
+    std::vector<double> values;
+    values.reserve(rows());
+    for (std::size_t c = begin; c < end; ++c) {
+      values.clear();
+      for (std::size_t r = 0; r < rows(); ++r) {
+        double v = data_[r][c];
+        if (v == v) values.push_back(v);
+      }
+      auto acfs = stats::autocorrelations(values, static_cast<int>(max_lag));
+      for (std::size_t lag = 0; lag < acfs.size(); ++lag) {
+        out.data_[lag][c] = acfs[lag];
+      }
+    }
+  });
 
   return out;
 }
@@ -1238,6 +3200,116 @@ DataFrame<IndexT> DataFrame<IndexT>::standardize() const {
   return out;
 }
 
+// Average ranks (1-based, ties share their mean rank) across each row's valid
+// values; pct divides by the row's valid count.
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::cross_sectional_rank(bool pct) const {
+  return apply_by_row([pct](const std::vector<double>& row, std::vector<double>& out,
+                            std::vector<std::pair<double, std::size_t>>& scratch) {
+    scratch.clear();
+    for (std::size_t c = 0; c < row.size(); ++c) {
+      out[c] = std::numeric_limits<double>::quiet_NaN();
+      if (row[c] == row[c]) scratch.emplace_back(row[c], c);
+    }
+    std::sort(scratch.begin(), scratch.end());
+    const double scale = pct ? 1.0 / static_cast<double>(scratch.size()) : 1.0;
+    for (std::size_t i = 0; i < scratch.size();) {
+      std::size_t j = i + 1;
+      while (j < scratch.size() && scratch[j].first == scratch[i].first) ++j;
+      const double rank = 0.5 * static_cast<double>(i + j + 1) * scale;
+      for (std::size_t t = i; t < j; ++t) out[scratch[t].second] = rank;
+      i = j;
+    }
+  });
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::cross_sectional_zscore() const {
+  return apply_by_row([](const std::vector<double>& row, std::vector<double>& out,
+                         std::vector<std::pair<double, std::size_t>>&) {
+    double sum = 0.0;
+    std::size_t count = 0;
+    for (double v : row) {
+      if (!(v == v)) continue;
+      sum += v;
+      ++count;
+    }
+    double sd = std::numeric_limits<double>::quiet_NaN();
+    const double mean = count > 0 ? sum / static_cast<double>(count) : sd;
+    if (count > 1) {
+      double accum = 0.0;
+      for (double v : row) {
+        if (v == v) accum += (v - mean) * (v - mean);
+      }
+      const double var = accum / static_cast<double>(count - 1);
+      if (var > 0.0) sd = std::sqrt(var);
+    }
+    for (std::size_t c = 0; c < row.size(); ++c) {
+      out[c] = (row[c] == row[c] && sd == sd) ? (row[c] - mean) / sd
+                                              : std::numeric_limits<double>::quiet_NaN();
+    }
+  });
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::cross_sectional_demean() const {
+  return apply_by_row([](const std::vector<double>& row, std::vector<double>& out,
+                         std::vector<std::pair<double, std::size_t>>&) {
+    double sum = 0.0;
+    std::size_t count = 0;
+    for (double v : row) {
+      if (!(v == v)) continue;
+      sum += v;
+      ++count;
+    }
+    const double mean = count > 0 ? sum / static_cast<double>(count) : 0.0;
+    for (std::size_t c = 0; c < row.size(); ++c) out[c] = row[c] - mean;
+  });
+}
+
+// Clamps each row's values to that row's [lower, upper] percentiles (0..100).
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::cross_sectional_winsorize(double lower_percentile,
+                                                               double upper_percentile) const {
+  if (!(lower_percentile >= 0.0) || !(upper_percentile <= 100.0) ||
+      !(lower_percentile <= upper_percentile)) {
+    throw std::runtime_error(
+        "dataframe::cross_sectional_winsorize: percentiles must satisfy 0 <= lower <= upper <= 100");
+  }
+  return apply_by_row([lower_percentile, upper_percentile](
+                          const std::vector<double>& row, std::vector<double>& out,
+                          std::vector<std::pair<double, std::size_t>>& scratch) {
+    scratch.clear();
+    for (double v : row) {
+      if (v == v) scratch.emplace_back(v, 0);
+    }
+    if (scratch.empty()) {
+      out = row;
+      return;
+    }
+    auto at_percentile = [&scratch](double percentile) {
+      const double rank = (percentile / 100.0) * static_cast<double>(scratch.size() - 1);
+      const std::size_t lo = static_cast<std::size_t>(rank);
+      const std::size_t hi = std::min(lo + 1, scratch.size() - 1);
+      auto by_value = [](const auto& a, const auto& b) { return a.first < b.first; };
+      std::nth_element(scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(lo),
+                       scratch.end(), by_value);
+      const double low_value = scratch[lo].first;
+      if (hi == lo) return low_value;
+      const double high_value =
+          std::min_element(scratch.begin() + static_cast<std::ptrdiff_t>(hi), scratch.end(),
+                           by_value)->first;
+      return low_value + (rank - static_cast<double>(lo)) * (high_value - low_value);
+    };
+    const double lower = at_percentile(lower_percentile);
+    const double upper = at_percentile(upper_percentile);
+    for (std::size_t c = 0; c < row.size(); ++c) {
+      const double v = row[c];
+      out[c] = (v == v) ? std::min(std::max(v, lower), upper) : v;
+    }
+  });
+}
+
 template <typename IndexT>
 DataFrame<IndexT> DataFrame<IndexT>::normalize() const {
   DataFrame<IndexT> out;
@@ -1332,6 +3404,79 @@ void DataFrame<IndexT>::add_column(const std::string& name,
   }
 }
 
+template <typename IndexT>
+void DataFrame<IndexT>::append_row(const IndexT& index_value,
+                                   const std::vector<double>& values) {
+  append_row(index_value, values.data(), values.size());
+}
+
+template <typename IndexT>
+void DataFrame<IndexT>::append_row(const IndexT& index_value,
+                                   const double* values,
+                                   std::size_t count) {
+  if (columns_.empty()) {
+    throw std::runtime_error("dataframe::append_row: dataframe has no columns");
+  }
+  if (count != columns_.size()) {
+    throw std::runtime_error("dataframe::append_row: value count mismatch");
+  }
+  if (count > 0 && !values) {
+    throw std::runtime_error("dataframe::append_row: values pointer is null");
+  }
+  // index_ and data_ grow geometrically, so appends are amortized O(columns).
+  data_.emplace_back(values, values + count);
+  try {
+    index_.push_back(index_value);
+  } catch (...) {
+    data_.pop_back();
+    throw;
+  }
+}
+
+template <typename IndexT>
+void DataFrame<IndexT>::append_rows(const DataFrame& batch) {
+  if (&batch == this) {
+    DataFrame<IndexT> copy = batch;
+    append_rows(copy);
+    return;
+  }
+  if (batch.columns_ != columns_) {
+    throw std::runtime_error("dataframe::append_rows: column mismatch");
+  }
+  if (batch.index_.size() != batch.data_.size()) {
+    throw std::runtime_error("dataframe::append_rows: index size mismatch");
+  }
+  const std::size_t needed = rows() + batch.rows();
+  if (needed > data_.capacity()) {
+    reserve_rows(std::max(needed, 2 * data_.capacity()));
+  }
+  // Copying a row can throw (bad_alloc); roll both back so index_ and data_
+  // keep the same length, as append_row does.
+  const std::size_t old_rows = rows();
+  try {
+    data_.insert(data_.end(), batch.data_.begin(), batch.data_.end());
+    index_.insert(index_.end(), batch.index_.begin(), batch.index_.end());
+  } catch (...) {
+    data_.erase(data_.begin() + static_cast<std::ptrdiff_t>(std::min(old_rows, data_.size())), data_.end());
+    index_.erase(index_.begin() + static_cast<std::ptrdiff_t>(std::min(old_rows, index_.size())), index_.end());
+    throw;
+  }
+}
+
+template <typename IndexT>
+void DataFrame<IndexT>::reserve_rows(std::size_t capacity) {
+  index_.reserve(capacity);
+  data_.reserve(capacity);
+}
+
+template <typename IndexT>
+void DataFrame<IndexT>::reserve_columns(std::size_t capacity) {
+  columns_.reserve(capacity);
+  for (auto& row : data_) {
+    row.reserve(capacity);
+  }
+}
+
 template <typename IndexT>
 template <typename T, typename>
 DataFrame<IndexT> DataFrame<IndexT>::slice_rows_range(IndexT start,
@@ -1463,36 +3608,64 @@ DataFrame<IndexT> DataFrame<IndexT>::sort_rows_by_column(const std::string& colu
   if (cols() == 0) {
     throw std::runtime_error("dataframe::sort_rows_by_column: no columns to sort by");
   }
-  const std::size_t column_index = find_column_index(column_name);
+  return select_rows_by_positions(argsort_rows({column_name}, {ascending}));
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::sort_rows_by_columns(
+    const std::vector<std::string>& column_names,
+    const std::vector<bool>& ascending) const {
+  return select_rows_by_positions(argsort_rows(column_names, ascending));
+}
+
+template <typename IndexT>
+std::vector<std::size_t> DataFrame<IndexT>::argsort_rows(
+    const std::vector<std::string>& column_names,
+    const std::vector<bool>& ascending) const {
+  if (column_names.empty()) {
+    throw std::runtime_error("dataframe::argsort_rows: no sort columns given");
+  }
+  if (!ascending.empty() && ascending.size() != column_names.size()) {
+    throw std::runtime_error("dataframe::argsort_rows: ascending flags do not match sort columns");
+  }
+  std::vector<std::size_t> key_columns;
+  key_columns.reserve(column_names.size());
+  for (const auto& name : column_names) key_columns.push_back(find_column_index(name));
+
   std::vector<std::size_t> order(rows());
   std::iota(order.begin(), order.end(), 0);
-  auto comparator = [&](std::size_t lhs, std::size_t rhs) {
-    double left_value = data_[lhs][column_index];
-    double right_value = data_[rhs][column_index];
-    const bool left_nan = !(left_value == left_value);
-    const bool right_nan = !(right_value == right_value);
-    if (left_nan || right_nan) {
-      if (left_nan && right_nan) return lhs < rhs;
-      if (ascending) {
-        return !left_nan && right_nan;
+
+  // Stable passes from the least to the most significant key. Each pass moves
+  // NaNs out first (after the values when ascending, before them when
+  // descending, as before), then radix-sorts the rest on order-preserving keys.
+  std::vector<std::uint64_t> keys;
+  std::vector<std::size_t> valid;
+  std::vector<std::size_t> missing;
+  for (std::size_t k = key_columns.size(); k-- > 0;) {
+    const std::size_t column = key_columns[k];
+    const bool up = ascending.empty() ? true : static_cast<bool>(ascending[k]);
+    keys.clear();
+    valid.clear();
+    missing.clear();
+    for (std::size_t position : order) {
+      const double v = data_[position][column];
+      if (v == v) {
+        keys.push_back(detail::orderable_key(v, up));
+        valid.push_back(position);
       } else {
-        return left_nan && !right_nan;
+        missing.push_back(position);
       }
     }
-    return ascending ? (left_value < right_value) : (left_value > right_value);
-  };
-  std::stable_sort(order.begin(), order.end(), comparator);
-
-  DataFrame<IndexT> out;
-  out.columns_ = columns_;
-  out.index_name_ = index_name_;
-  out.index_.reserve(order.size());
-  out.data_.reserve(order.size());
-  for (std::size_t position : order) {
-    out.index_.push_back(index_[position]);
-    out.data_.push_back(data_[position]);
+    detail::radix_sort_pairs(keys, valid);
+    if (up) {
+      std::copy(valid.begin(), valid.end(), order.begin());
+      std::copy(missing.begin(), missing.end(), order.begin() + static_cast<std::ptrdiff_t>(valid.size()));
+    } else {
+      std::copy(missing.begin(), missing.end(), order.begin());
+      std::copy(valid.begin(), valid.end(), order.begin() + static_cast<std::ptrdiff_t>(missing.size()));
+    }
   }
-  return out;
+  return order;
 }
 
 template <typename IndexT>
@@ -1540,6 +3713,49 @@ DataFrame<IndexT> DataFrame<IndexT>::sort_columns_by_row(const IndexT& index_val
   return out;
 }
 
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::nlargest(std::size_t count,
+                                              const std::string& column_name) const {
+  const std::size_t column_index = find_column_index(column_name);
+  std::vector<std::pair<double, std::size_t>> candidates;
+  candidates.reserve(rows());
+  for (std::size_t r = 0; r < rows(); ++r) {
+    const double v = data_[r][column_index];
+    if (v == v) candidates.emplace_back(v, r);
+  }
+  return select_rows_by_positions(detail::top_k_positions(std::move(candidates), count, true));
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::nsmallest(std::size_t count,
+                                               const std::string& column_name) const {
+  const std::size_t column_index = find_column_index(column_name);
+  std::vector<std::pair<double, std::size_t>> candidates;
+  candidates.reserve(rows());
+  for (std::size_t r = 0; r < rows(); ++r) {
+    const double v = data_[r][column_index];
+    if (v == v) candidates.emplace_back(v, r);
+  }
+  return select_rows_by_positions(detail::top_k_positions(std::move(candidates), count, false));
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::top_k_columns(const IndexT& index_value,
+                                                   std::size_t count,
+                                                   bool largest) const {
+  if (rows() == 0) {
+    throw std::runtime_error("dataframe::top_k_columns: no rows available");
+  }
+  const std::size_t row_position = find_row_position(index_value);
+  std::vector<std::pair<double, std::size_t>> candidates;
+  candidates.reserve(cols());
+  for (std::size_t c = 0; c < cols(); ++c) {
+    const double v = data_[row_position][c];
+    if (v == v) candidates.emplace_back(v, c);
+  }
+  return select_columns_by_positions(detail::top_k_positions(std::move(candidates), count, largest));
+}
+
 template <typename IndexT>
 DataFrame<IndexT> DataFrame<IndexT>::rolling_mean(std::size_t window) const {
   if (window == 0) {
@@ -1716,18 +3932,283 @@ DataFrame<IndexT> DataFrame<IndexT>::exponential_moving_average(double alpha) co
         ema = value;
         has_ema = true;
       } else {
-        ema = alpha * value + (1.0 - alpha) * ema;
+        ema = alpha * value + (1.0 - alpha) * ema;
+      }
+      out.data_[r][c] = ema;
+    }
+  }
+
+  return out;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::ewm_var(double alpha, bool demean) const {
+  if (!(alpha > 0.0) || !(alpha < 1.0)) {
+    throw std::runtime_error("dataframe::ewm_var: alpha must be in (0,1)");
+  }
+  // Same recursion as EwmCovariance for a single column; NaN inputs give NaN
+  // outputs without touching the state. The demeaned variance is NaN until the
+  // second observation.
+  return apply_by_column([alpha, demean](std::size_t, const std::vector<double>& values) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> result(values.size(), nan);
+    double mean = 0.0;
+    double var = 0.0;
+    std::size_t count = 0;
+    for (std::size_t r = 0; r < values.size(); ++r) {
+      const double x = values[r];
+      if (!(x == x)) continue;
+      if (demean) {
+        if (count == 0) {
+          mean = x;
+        } else {
+          const double d = x - mean;
+          mean += alpha * d;
+          var = (1.0 - alpha) * (var + alpha * d * d);
+        }
+      } else {
+        var = (count == 0) ? x * x : (1.0 - alpha) * var + alpha * x * x;
+      }
+      ++count;
+      if (!demean || count > 1) result[r] = var;
+    }
+    return result;
+  });
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::ewm_std(double alpha, bool demean) const {
+  DataFrame<IndexT> out = ewm_var(alpha, demean);
+  for (auto& row : out.data_) {
+    for (double& value : row) {
+      if (value == value) value = std::sqrt(std::max(value, 0.0));
+    }
+  }
+  return out;
+}
+
+template <typename IndexT>
+DataFrame<std::string> DataFrame<IndexT>::ewm_cov_matrix(double alpha, bool demean) const {
+  if (columns_.empty()) {
+    throw std::runtime_error("dataframe::ewm_cov_matrix: no columns");
+  }
+  EwmCovariance cov(columns_, alpha, demean);
+  cov.update(*this);
+  return cov.covariance_matrix();
+}
+
+template <typename IndexT>
+DataFrame<std::string> DataFrame<IndexT>::garch_fit_dataframe() const {
+  static const std::vector<std::string> labels = {"n", "mu", "omega", "alpha",
+                                                  "beta", "log_likelihood"};
+  DataFrame<std::string> out;
+  out.columns_ = columns_;
+  out.index_ = labels;
+  out.index_name_ = "parameter";
+  out.data_.assign(labels.size(), std::vector<double>(cols(), 0.0));
+
+  detail::parallel_for(cols(), [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = begin; c < end; ++c) {
+      std::vector<double> values(rows());
+      for (std::size_t r = 0; r < rows(); ++r) values[r] = data_[r][c];
+      stats::Garch11Fit fit = stats::fit_garch11(values);
+      out.data_[0][c] = static_cast<double>(fit.n);
+      out.data_[1][c] = fit.mu;
+      out.data_[2][c] = fit.omega;
+      out.data_[3][c] = fit.alpha;
+      out.data_[4][c] = fit.beta;
+      out.data_[5][c] = fit.log_likelihood;
+    }
+  });
+
+  return out;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::garch_volatility() const {
+  return garch_volatility(garch_fit_dataframe());
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::garch_volatility(const DataFrame<std::string>& fits) const {
+  if (fits.columns_ != columns_) {
+    throw std::runtime_error("dataframe::garch_volatility: fit columns do not match frame");
+  }
+  std::vector<stats::Garch11Fit> params(cols());
+  for (std::size_t c = 0; c < cols(); ++c) {
+    params[c].mu = fits.data_[fits.find_row_position("mu")][c];
+    params[c].omega = fits.data_[fits.find_row_position("omega")][c];
+    params[c].alpha = fits.data_[fits.find_row_position("alpha")][c];
+    params[c].beta = fits.data_[fits.find_row_position("beta")][c];
+  }
+  return apply_by_column([&](std::size_t c, const std::vector<double>& values) {
+    return stats::garch11_conditional_sd(values, params[c]);
+  });
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::ewma_volatility(double lambda) const {
+  if (!(lambda > 0.0) || !(lambda < 1.0)) {
+    throw std::runtime_error("dataframe::ewma_volatility: lambda must be in (0,1)");
+  }
+  return apply_by_column([lambda](std::size_t, const std::vector<double>& values) {
+    return stats::ewma_conditional_sd(values, lambda);
+  });
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::standardize_returns(const DataFrame& cond_sd,
+                                                         double fill_value) const {
+  if (rows() != cond_sd.rows() || cols() != cond_sd.cols()) {
+    throw std::runtime_error("dataframe::standardize_returns: shape mismatch");
+  }
+  if (columns_ != cond_sd.columns_) {
+    throw std::runtime_error("dataframe::standardize_returns: column mismatch");
+  }
+  if (index_ != cond_sd.index_) {
+    throw std::runtime_error("dataframe::standardize_returns: index mismatch");
+  }
+  return apply_by_column([&](std::size_t c, const std::vector<double>& values) {
+    std::vector<double> sd(rows());
+    for (std::size_t r = 0; r < rows(); ++r) sd[r] = cond_sd.data_[r][c];
+    return stats::standardize_returns(values, sd, fill_value);
+  });
+}
+
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::resample_time(
+    Duration bucket,
+    const std::vector<std::pair<std::string, Aggregation>>& aggregations) const {
+  static_assert(std::is_same_v<IndexT, Date> || std::is_same_v<IndexT, DateTime>,
+                "resample_time requires a Date or DateTime index");
+  constexpr long long unit = std::is_same_v<IndexT, Date> ? 86400 : 1;
+  if (bucket.seconds <= 0 || bucket.seconds % unit != 0) {
+    throw std::runtime_error(
+        "dataframe::resample_time: bucket must be positive (whole days for Date indices)");
+  }
+  if (aggregations.empty()) {
+    throw std::runtime_error("dataframe::resample_time: no aggregations specified");
+  }
+  const long long width = bucket.seconds / unit;
+  auto to_ticks = [](const IndexT& value) {
+    if constexpr (std::is_same_v<IndexT, Date>) {
+      return days_since_epoch(value);
+    } else {
+      return seconds_since_epoch(value);
+    }
+  };
+  auto from_ticks = [](long long ticks) {
+    if constexpr (std::is_same_v<IndexT, Date>) {
+      return date_from_days(ticks);
+    } else {
+      return datetime_from_seconds(ticks);
+    }
+  };
+
+  const std::size_t k = aggregations.size();
+  std::vector<std::size_t> source(k);
+  std::vector<Aggregation> kinds(k);
+  DataFrame<IndexT> out;
+  out.index_name_ = index_name_;
+  out.columns_.reserve(k);
+  for (std::size_t i = 0; i < k; ++i) {
+    source[i] = find_column_index(aggregations[i].first);
+    kinds[i] = aggregations[i].second;
+    out.columns_.push_back(aggregations[i].first);
+  }
+
+  // One pass over the (sorted) rows: accumulate into per-column state until
+  // the bucket key changes, then emit the finished bucket.
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> acc(k);
+  std::vector<std::size_t> counts(k);
+  long long current_key = 0;
+  bool open = false;
+  auto reset = [&]() {
+    for (std::size_t i = 0; i < k; ++i) {
+      counts[i] = 0;
+      acc[i] = (kinds[i] == Aggregation::sum || kinds[i] == Aggregation::mean ||
+                kinds[i] == Aggregation::count)
+                   ? 0.0
+                   : nan;
+    }
+  };
+  auto emit = [&]() {
+    std::vector<double> row(k);
+    for (std::size_t i = 0; i < k; ++i) {
+      if (kinds[i] == Aggregation::count) {
+        row[i] = static_cast<double>(counts[i]);
+      } else if (counts[i] == 0) {
+        row[i] = nan;
+      } else if (kinds[i] == Aggregation::mean) {
+        row[i] = acc[i] / static_cast<double>(counts[i]);
+      } else {
+        row[i] = acc[i];
       }
-      out.data_[r][c] = ema;
+    }
+    out.index_.push_back(from_ticks(current_key * width));
+    out.data_.push_back(std::move(row));
+  };
+
+  long long previous_ticks = 0;
+  for (std::size_t r = 0; r < rows(); ++r) {
+    const long long ticks = to_ticks(index_[r]);
+    if (r > 0 && ticks < previous_ticks) {
+      throw std::runtime_error("dataframe::resample_time: index must be sorted ascending");
+    }
+    previous_ticks = ticks;
+    const long long key = (ticks >= 0) ? ticks / width : -((-ticks + width - 1) / width);
+    if (!open || key != current_key) {
+      if (open) emit();
+      current_key = key;
+      open = true;
+      reset();
+    }
+    const std::vector<double>& row = data_[r];
+    for (std::size_t i = 0; i < k; ++i) {
+      const double v = row[source[i]];
+      if (!(v == v)) continue;
+      switch (kinds[i]) {
+        case Aggregation::first:
+          if (counts[i] == 0) acc[i] = v;
+          break;
+        case Aggregation::last:
+          acc[i] = v;
+          break;
+        case Aggregation::min:
+          if (counts[i] == 0 || v < acc[i]) acc[i] = v;
+          break;
+        case Aggregation::max:
+          if (counts[i] == 0 || v > acc[i]) acc[i] = v;
+          break;
+        case Aggregation::sum:
+        case Aggregation::mean:
+          acc[i] += v;
+          break;
+        case Aggregation::count:
+          break;
+      }
+      ++counts[i];
     }
   }
+  if (open) emit();
 
   return out;
 }
 
+template <typename IndexT>
+DataFrame<IndexT> DataFrame<IndexT>::resample_time(Duration bucket,
+                                                   Aggregation aggregation) const {
+  std::vector<std::pair<std::string, Aggregation>> aggregations;
+  aggregations.reserve(cols());
+  for (const auto& name : columns_) aggregations.emplace_back(name, aggregation);
+  return resample_time(bucket, aggregations);
+}
+
 template <typename IndexT>
 DataFrame<IndexT> DataFrame<IndexT>::resample_rows(std::size_t sample_size,
-                                                   bool reset_index) const {
+                                                   bool reset_index,
+                                                   std::uint64_t seed) const {
   if (rows() == 0) {
     throw std::runtime_error("dataframe::resample_rows: no rows to sample");
   }
@@ -1738,12 +4219,12 @@ DataFrame<IndexT> DataFrame<IndexT>::resample_rows(std::size_t sample_size,
   out.data_.reserve(sample_size);
   out.index_.reserve(sample_size);
 
-  std::random_device rd;
-  std::mt19937 rng(rd());
-  std::uniform_int_distribution<std::size_t> dist(0, rows() - 1);
+  std::mt19937_64 rng(detail::splitmix64(detail::resolve_seed(seed) ^ detail::splitmix64(0)));
+  std::vector<std::size_t> picks;
+  detail::draw_bootstrap_positions(rows(), sample_size, BootstrapMethod::iid, 1, rng, picks);
 
   for (std::size_t i = 0; i < sample_size; ++i) {
-    std::size_t pick = dist(rng);
+    std::size_t pick = picks[i];
     out.data_.push_back(data_[pick]);
     if constexpr (std::is_integral_v<IndexT>) {
       if (reset_index) {
@@ -1762,6 +4243,135 @@ DataFrame<IndexT> DataFrame<IndexT>::resample_rows(std::size_t sample_size,
 
   return out;
 }
+
+template <typename IndexT>
+template <typename Statistic>
+DataFrame<int> DataFrame<IndexT>::bootstrap(const std::vector<std::string>& labels,
+                                            Statistic statistic,
+                                            const BootstrapOptions& options) const {
+  if (rows() == 0) {
+    throw std::runtime_error("dataframe::bootstrap: no rows to sample");
+  }
+  if (labels.empty()) {
+    throw std::runtime_error("dataframe::bootstrap: statistic needs at least one label");
+  }
+  if (options.replicates == 0) {
+    throw std::runtime_error("dataframe::bootstrap: replicates must be positive");
+  }
+  if (options.replicates > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+    throw std::runtime_error("dataframe::bootstrap: replicate count exceeds index capacity");
+  }
+  if (options.method != BootstrapMethod::iid && options.block_length == 0) {
+    throw std::runtime_error("dataframe::bootstrap: block_length must be positive");
+  }
+  const std::size_t sample_size = options.sample_size == 0 ? rows() : options.sample_size;
+  const std::uint64_t base_seed = detail::resolve_seed(options.seed);
+
+  DataFrame<int> out;
+  out.columns_ = labels;
+  out.index_name_ = "replicate";
+  out.index_.resize(options.replicates);
+  for (std::size_t b = 0; b < options.replicates; ++b) out.index_[b] = static_cast<int>(b);
+  out.data_.assign(options.replicates, std::vector<double>(labels.size(), 0.0));
+
+  // Replicate b always draws from the stream seeded by (seed, b), so results do
+  // not depend on how replicates are spread across threads. Resamples are
+  // never materialized: the statistic sees only the drawn row positions.
+  detail::parallel_for(options.replicates, [&](std::size_t begin, std::size_t end) {
+    std::vector<std::size_t> positions;
+    positions.reserve(sample_size);
+    for (std::size_t b = begin; b < end; ++b) {
+      std::mt19937_64 rng(detail::splitmix64(base_seed ^ detail::splitmix64(b)));
+      detail::draw_bootstrap_positions(rows(), sample_size, options.method,
+                                       options.block_length, rng, positions);
+      std::vector<double>& result = out.data_[b];
+      statistic(positions, result);
+      if (result.size() != labels.size()) {
+        throw std::runtime_error("dataframe::bootstrap: statistic returned wrong number of values");
+      }
+    }
+  });
+
+  return out;
+}
+
+template <typename IndexT>
+DataFrame<int> DataFrame<IndexT>::bootstrap_column_means(const BootstrapOptions& options) const {
+  return bootstrap(columns_,
+                   [this](const std::vector<std::size_t>& positions, std::vector<double>& result) {
+                     for (std::size_t c = 0; c < cols(); ++c) {
+                       double sum = 0.0;
+                       std::size_t count = 0;
+                       for (std::size_t r : positions) {
+                         double v = data_[r][c];
+                         if (!(v == v)) continue;
+                         sum += v;
+                         ++count;
+                       }
+                       result[c] = count > 0 ? sum / static_cast<double>(count)
+                                             : std::numeric_limits<double>::quiet_NaN();
+                     }
+                   },
+                   options);
+}
+
+template <typename IndexT>
+DataFrame<int> DataFrame<IndexT>::bootstrap_column_percentiles(
+    double percentile,
+    const BootstrapOptions& options) const {
+  if (percentile < 0.0 || percentile > 100.0) {
+    throw std::runtime_error("dataframe::bootstrap_column_percentiles: percentile must be in [0, 100]");
+  }
+  return bootstrap(columns_,
+                   [this, percentile](const std::vector<std::size_t>& positions,
+                                      std::vector<double>& result) {
+                     std::vector<double> values;
+                     values.reserve(positions.size());
+                     for (std::size_t c = 0; c < cols(); ++c) {
+                       values.clear();
+                       for (std::size_t r : positions) {
+                         double v = data_[r][c];
+                         if (v == v) values.push_back(v);
+                       }
+                       std::sort(values.begin(), values.end());
+                       result[c] = detail::sorted_percentile(values, percentile);
+                     }
+                   },
+                   options);
+}
+
+template <typename IndexT>
+DataFrame<int> DataFrame<IndexT>::bootstrap_correlations(const BootstrapOptions& options) const {
+  if (cols() < 2) {
+    throw std::runtime_error("dataframe::bootstrap_correlations: need at least two columns");
+  }
+  // Like correlation_matrix, only complete rows take part; they are resampled
+  // directly and each replicate reports the upper triangle as "a:b" columns.
+  const std::vector<std::size_t> valid_rows = complete_row_positions();
+  if (valid_rows.size() < 2) {
+    throw std::runtime_error("dataframe::bootstrap_correlations: need at least two non-NaN rows");
+  }
+  std::vector<std::string> labels;
+  for (std::size_t i = 0; i < cols(); ++i) {
+    for (std::size_t j = i + 1; j < cols(); ++j) {
+      labels.push_back(columns_[i] + ":" + columns_[j]);
+    }
+  }
+  DataFrame<IndexT> complete = select_rows_by_positions(valid_rows);
+  return complete.bootstrap(labels,
+                            [&complete](const std::vector<std::size_t>& positions,
+                                        std::vector<double>& result) {
+                              std::vector<std::vector<double>> corr;
+                              complete.correlations_over_positions(positions, corr);
+                              std::size_t k = 0;
+                              for (std::size_t i = 0; i < corr.size(); ++i) {
+                                for (std::size_t j = i + 1; j < corr.size(); ++j) {
+                                  result[k++] = corr[i][j];
+                                }
+                              }
+                            },
+                            options);
+}
 
 template <typename IndexT>
 DataFrame<IndexT> DataFrame<IndexT>::remove_rows_with_nan() const {
@@ -1821,6 +4431,190 @@ DataFrame<IndexT> DataFrame<IndexT>::apply_unary(Func func, const char*) const {
   return apply_scalar(func);
 }
 
+// Runs func(column_position, column_values) for every column in parallel and
+// assembles the returned vectors (one value per row) into a frame shaped like this one.
+template <typename IndexT>
+template <typename Func>
+DataFrame<IndexT> DataFrame<IndexT>::apply_by_column(Func func) const {
+  DataFrame<IndexT> out;
+  out.columns_ = columns_;
+  out.index_ = index_;
+  out.index_name_ = index_name_;
+  out.data_.assign(rows(), std::vector<double>(cols(), 0.0));
+  detail::parallel_for(cols(), [&](std::size_t begin, std::size_t end) {
+    std::vector<double> values(rows());
+    for (std::size_t c = begin; c < end; ++c) {
+      for (std::size_t r = 0; r < rows(); ++r) values[r] = data_[r][c];
+      std::vector<double> result = func(c, values);
+      if (result.size() != rows()) {
+        throw std::runtime_error("dataframe::apply_by_column: result length mismatch");
+      }
+      for (std::size_t r = 0; r < rows(); ++r) out.data_[r][c] = result[r];
+    }
+  });
+  return out;
+}
+
+// Runs func(row, out_row, scratch) over every row in parallel; out_row is
+// preallocated to cols() and scratch is a per-thread buffer the kernel may reuse.
+template <typename IndexT>
+template <typename Func>
+DataFrame<IndexT> DataFrame<IndexT>::apply_by_row(Func func) const {
+  DataFrame<IndexT> out;
+  out.columns_ = columns_;
+  out.index_ = index_;
+  out.index_name_ = index_name_;
+  out.data_.assign(rows(), std::vector<double>(cols(), 0.0));
+  detail::parallel_for(rows(), [&](std::size_t begin, std::size_t end) {
+    std::vector<std::pair<double, std::size_t>> scratch;
+    scratch.reserve(cols());
+    for (std::size_t r = begin; r < end; ++r) {
+      func(data_[r], out.data_[r], scratch);
+    }
+  }, 64);
+  return out;
+}
+
+// Running op over each column of prepare(value), skipping NaNs (they stay NaN
+// and do not reset the accumulation); finish maps each accumulated value into
+// the result. Tall frames use a two-pass blocked scan: blocks accumulate
+// locally in parallel, block totals are chained, then each block folds in its
+// carry. Shorter frames are scanned column by column in parallel. op must be
+// associative.
+template <typename IndexT>
+template <typename Op, typename Prepare, typename Finish>
+DataFrame<IndexT> DataFrame<IndexT>::cumulative_scan(Op op,
+                                                     Prepare prepare,
+                                                     Finish finish) const {
+  const std::size_t n = rows();
+  const std::size_t k = cols();
+  std::size_t blocks = static_cast<std::size_t>(std::thread::hardware_concurrency());
+  if (blocks == 0) blocks = 1;
+  blocks = std::max<std::size_t>(1, std::min(blocks, n / 65536));
+
+  if (blocks == 1) {
+    return apply_by_column([&](std::size_t, const std::vector<double>& values) {
+      std::vector<double> result(values.size());
+      bool started = false;
+      double running = 0.0;
+      for (std::size_t r = 0; r < values.size(); ++r) {
+        const double v = values[r];
+        if (!(v == v)) {
+          result[r] = v;
+          continue;
+        }
+        running = started ? op(running, prepare(v)) : prepare(v);
+        started = true;
+        result[r] = finish(running);
+      }
+      return result;
+    });
+  }
+
+  DataFrame<IndexT> out;
+  out.columns_ = columns_;
+  out.index_ = index_;
+  out.index_name_ = index_name_;
+  out.data_.assign(n, std::vector<double>(k, 0.0));
+
+  const std::size_t block_size = (n + blocks - 1) / blocks;
+  std::vector<double> totals(blocks * k, 0.0);
+  std::vector<unsigned char> has_total(blocks * k, 0);
+  detail::parallel_for(blocks, [&](std::size_t block_begin, std::size_t block_end) {
+    for (std::size_t b = block_begin; b < block_end; ++b) {
+      double* running = &totals[b * k];
+      unsigned char* started = &has_total[b * k];
+      const std::size_t end = std::min(n, (b + 1) * block_size);
+      for (std::size_t r = b * block_size; r < end; ++r) {
+        const std::vector<double>& source = data_[r];
+        std::vector<double>& dest = out.data_[r];
+        for (std::size_t c = 0; c < k; ++c) {
+          const double v = source[c];
+          if (!(v == v)) {
+            dest[c] = v;
+            continue;
+          }
+          running[c] = started[c] ? op(running[c], prepare(v)) : prepare(v);
+          started[c] = 1;
+          dest[c] = running[c];
+        }
+      }
+    }
+  });
+
+  // Turn block totals into the carry each block starts from.
+  std::vector<double> carry(blocks * k, 0.0);
+  std::vector<unsigned char> has_carry(blocks * k, 0);
+  for (std::size_t b = 1; b < blocks; ++b) {
+    for (std::size_t c = 0; c < k; ++c) {
+      const std::size_t prev = (b - 1) * k + c;
+      double value = carry[prev];
+      bool present = has_carry[prev] != 0;
+      if (has_total[prev]) {
+        value = present ? op(value, totals[prev]) : totals[prev];
+        present = true;
+      }
+      carry[b * k + c] = value;
+      has_carry[b * k + c] = present ? 1 : 0;
+    }
+  }
+
+  detail::parallel_for(blocks, [&](std::size_t block_begin, std::size_t block_end) {
+    for (std::size_t b = block_begin; b < block_end; ++b) {
+      const double* offset = &carry[b * k];
+      const unsigned char* present = &has_carry[b * k];
+      const std::size_t end = std::min(n, (b + 1) * block_size);
+      for (std::size_t r = b * block_size; r < end; ++r) {
+        std::vector<double>& dest = out.data_[r];
+        for (std::size_t c = 0; c < k; ++c) {
+          const double v = dest[c];
+          if (!(v == v)) continue;
+          dest[c] = finish(present[c] ? op(offset[c], v) : v);
+        }
+      }
+    }
+  });
+  return out;
+}
+
+// Row r of the result is func(value at r, value at r - lag) per column; rows
+// whose lagged row falls outside the frame are NaN, or dropped when trim is set.
+// A negative lag looks ahead.
+template <typename IndexT>
+template <typename Func>
+DataFrame<IndexT> DataFrame<IndexT>::lagged_transform(long long lag,
+                                                      bool trim,
+                                                      Func func) const {
+  const long long row_count = static_cast<long long>(rows());
+  const long long first = trim ? std::min(row_count, std::max(0LL, lag)) : 0;
+  const long long last = trim ? std::max(first, row_count + std::min(0LL, lag)) : row_count;
+  DataFrame<IndexT> out;
+  out.columns_ = columns_;
+  out.index_name_ = index_name_;
+  out.index_.assign(index_.begin() + static_cast<std::ptrdiff_t>(first),
+                    index_.begin() + static_cast<std::ptrdiff_t>(last));
+  out.data_.assign(static_cast<std::size_t>(last - first), std::vector<double>(cols(), 0.0));
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  detail::parallel_for(out.data_.size(), [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const long long r = first + static_cast<long long>(i);
+      const long long source = r - lag;
+      std::vector<double>& dest = out.data_[i];
+      if (source < 0 || source >= row_count) {
+        std::fill(dest.begin(), dest.end(), nan);
+        continue;
+      }
+      const std::vector<double>& current = data_[static_cast<std::size_t>(r)];
+      const std::vector<double>& lagged = data_[static_cast<std::size_t>(source)];
+      for (std::size_t c = 0; c < dest.size(); ++c) {
+        dest[c] = func(current[c], lagged[c]);
+      }
+    }
+  }, 4096);
+  return out;
+}
+
 template <typename IndexT>
 template <typename Func>
 DataFrame<IndexT> DataFrame<IndexT>::apply_binary(const DataFrame& other,
@@ -1848,6 +4642,24 @@ DataFrame<IndexT> DataFrame<IndexT>::apply_binary(const DataFrame& other,
   return out;
 }
 
+template <typename IndexT>
+std::vector<std::size_t> DataFrame<IndexT>::complete_row_positions() const {
+  std::vector<std::size_t> positions;
+  positions.reserve(rows());
+  for (std::size_t r = 0; r < rows(); ++r) {
+    bool has_nan = false;
+    for (std::size_t c = 0; c < cols(); ++c) {
+      const double v = data_[r][c];
+      if (!(v == v)) {
+        has_nan = true;
+        break;
+      }
+    }
+    if (!has_nan) positions.push_back(r);
+  }
+  return positions;
+}
+
 template <typename IndexT>
 DataFrame<IndexT> DataFrame<IndexT>::select_rows_by_positions(
     const std::vector<std::size_t>& positions) const {
@@ -1936,6 +4748,364 @@ double DataFrame<IndexT>::value(std::size_t row, std::size_t col) const {
   return data_[row][col];
 }
 
+inline EwmCovariance::EwmCovariance(const std::vector<std::string>& columns,
+                                    double alpha,
+                                    bool demean)
+    : columns_(columns), alpha_(alpha), demean_(demean) {
+  if (columns_.empty()) {
+    throw std::runtime_error("ewm_covariance: at least one column is required");
+  }
+  if (!(alpha > 0.0) || !(alpha < 1.0)) {
+    throw std::runtime_error("ewm_covariance: alpha must be in (0,1)");
+  }
+  const std::size_t k = columns_.size();
+  mean_.assign(k, 0.0);
+  cov_.assign(k * k, 0.0);
+  diff_.assign(k, 0.0);
+}
+
+inline void EwmCovariance::update(const double* row) {
+  fold(row);
+  ++consumed_;
+}
+
+inline void EwmCovariance::fold(const double* row) {
+  const std::size_t k = columns_.size();
+  for (std::size_t i = 0; i < k; ++i) {
+    if (!(row[i] == row[i])) return;
+  }
+  const double decay = 1.0 - alpha_;
+  if (demean_) {
+    if (count_ == 0) {
+      std::copy(row, row + k, mean_.begin());
+    } else {
+      for (std::size_t i = 0; i < k; ++i) {
+        diff_[i] = row[i] - mean_[i];
+        mean_[i] += alpha_ * diff_[i];
+      }
+      for (std::size_t i = 0; i < k; ++i) {
+        double* cov_row = &cov_[i * k];
+        const double scaled = alpha_ * diff_[i];
+        for (std::size_t j = i; j < k; ++j) {
+          cov_row[j] = decay * (cov_row[j] + scaled * diff_[j]);
+        }
+      }
+    }
+  } else {
+    const double weight = (count_ == 0) ? 1.0 : alpha_;
+    const double keep = (count_ == 0) ? 0.0 : decay;
+    for (std::size_t i = 0; i < k; ++i) {
+      double* cov_row = &cov_[i * k];
+      const double scaled = weight * row[i];
+      for (std::size_t j = i; j < k; ++j) {
+        cov_row[j] = keep * cov_row[j] + scaled * row[j];
+      }
+    }
+  }
+  ++count_;
+}
+
+inline void EwmCovariance::update(const std::vector<double>& row) {
+  if (row.size() != columns_.size()) {
+    throw std::runtime_error("ewm_covariance::update: row size does not match column count");
+  }
+  update(row.data());
+}
+
+template <typename IndexT>
+void EwmCovariance::update(const DataFrame<IndexT>& frame) {
+  if (frame.columns_ != columns_) {
+    throw std::runtime_error("ewm_covariance::update: frame columns do not match");
+  }
+  if (frame.rows() < consumed_) {
+    throw std::runtime_error("ewm_covariance::update: frame has fewer rows than already consumed");
+  }
+  for (std::size_t r = consumed_; r < frame.rows(); ++r) {
+    fold(frame.data_[r].data());
+  }
+  consumed_ = frame.rows();
+}
+
+inline double EwmCovariance::covariance(std::size_t i, std::size_t j) const {
+  const std::size_t k = columns_.size();
+  if (i >= k || j >= k) {
+    throw std::out_of_range("ewm_covariance::covariance: index out of range");
+  }
+  if (count_ == 0 || (demean_ && count_ < 2)) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return (i <= j) ? cov_[i * k + j] : cov_[j * k + i];
+}
+
+inline DataFrame<std::string> EwmCovariance::covariance_matrix() const {
+  const std::size_t k = columns_.size();
+  std::vector<std::vector<double>> data(k, std::vector<double>(k, 0.0));
+  for (std::size_t i = 0; i < k; ++i) {
+    for (std::size_t j = 0; j < k; ++j) data[i][j] = covariance(i, j);
+  }
+  DataFrame<std::string> out = DataFrame<std::string>::from_vectors(columns_, columns_, data);
+  out.set_index_name("column");
+  return out;
+}
+
+inline DataFrame<std::string> EwmCovariance::correlation_matrix() const {
+  const std::size_t k = columns_.size();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<std::vector<double>> data(k, std::vector<double>(k, 0.0));
+  for (std::size_t i = 0; i < k; ++i) {
+    for (std::size_t j = 0; j < k; ++j) {
+      const double vi = covariance(i, i);
+      const double vj = covariance(j, j);
+      if (i == j) {
+        data[i][j] = 1.0;
+      } else if (vi > 0.0 && vj > 0.0) {
+        data[i][j] = covariance(i, j) / std::sqrt(vi * vj);
+      } else {
+        data[i][j] = nan;
+      }
+    }
+  }
+  DataFrame<std::string> out = DataFrame<std::string>::from_vectors(columns_, columns_, data);
+  out.set_index_name("column");
+  return out;
+}
+
+// Immutable, reference-counted handle to a DataFrame. Copies share one frame
+// through std::shared_ptr (atomic reference count), so handing a frozen frame
+// to many worker threads costs no data copies.
+//
+// Thread-safety guarantee: every const DataFrame member may be called
+// concurrently from any number of threads on the same frame as long as nothing
+// mutates it, and a FrozenDataFrame offers only const access. Use thaw() to get
+// a private mutable copy.
+template <typename IndexT>
+class FrozenDataFrame {
+ public:
+  FrozenDataFrame() = default;
+  explicit FrozenDataFrame(DataFrame<IndexT> frame)
+      : frame_(std::make_shared<const DataFrame<IndexT>>(std::move(frame))) {}
+
+  const DataFrame<IndexT>& get() const;
+  const DataFrame<IndexT>& operator*() const { return get(); }
+  const DataFrame<IndexT>* operator->() const { return &get(); }
+  explicit operator bool() const { return static_cast<bool>(frame_); }
+  long use_count() const { return frame_.use_count(); }
+  DataFrame<IndexT> thaw() const { return get(); }
+
+ private:
+  std::shared_ptr<const DataFrame<IndexT>> frame_;
+};
+
+template <typename IndexT>
+const DataFrame<IndexT>& FrozenDataFrame<IndexT>::get() const {
+  if (!frame_) {
+    throw std::runtime_error("frozen_dataframe: empty handle");
+  }
+  return *frame_;
+}
+
+template <typename IndexT>
+FrozenDataFrame<IndexT> DataFrame<IndexT>::share() const& {
+  return FrozenDataFrame<IndexT>(*this);
+}
+
+template <typename IndexT>
+FrozenDataFrame<IndexT> DataFrame<IndexT>::share() && {
+  return FrozenDataFrame<IndexT>(std::move(*this));
+}
+
+// Streaming counterpart of rolling_mean / rolling_std / rolling_rms. update()
+// consumes only the rows of source appended since the previous call, keeping
+// a ring of the last window values per column, and extends output() with the
+// results. Window sums are rebuilt from the ring each time it wraps so
+// rounding error does not accumulate over long feeds.
+template <typename IndexT>
+class RollingOperator {
+ public:
+  RollingOperator(std::size_t window, RollingStatistic statistic);
+
+  const DataFrame<IndexT>& update(const DataFrame<IndexT>& source);
+  const DataFrame<IndexT>& output() const { return output_; }
+  std::size_t consumed() const { return consumed_; }
+
+ private:
+  void resum();
+  double result(std::size_t c) const;
+
+  std::size_t window_;
+  RollingStatistic statistic_;
+  std::size_t consumed_ = 0;
+  bool initialized_ = false;
+  std::vector<double> ring_;
+  std::vector<double> sums_;
+  std::vector<double> sums_sq_;
+  std::vector<std::size_t> valid_counts_;
+  DataFrame<IndexT> output_;
+};
+
+template <typename IndexT>
+RollingOperator<IndexT>::RollingOperator(std::size_t window, RollingStatistic statistic)
+    : window_(window), statistic_(statistic) {
+  if (window == 0) {
+    throw std::runtime_error("rolling_operator: window must be positive");
+  }
+}
+
+template <typename IndexT>
+const DataFrame<IndexT>& RollingOperator<IndexT>::update(const DataFrame<IndexT>& source) {
+  if (!initialized_) {
+    const std::size_t k = source.cols();
+    output_.columns_ = source.columns_;
+    output_.index_name_ = source.index_name_;
+    ring_.assign(window_ * k, 0.0);
+    sums_.assign(k, 0.0);
+    sums_sq_.assign(k, 0.0);
+    valid_counts_.assign(k, 0);
+    initialized_ = true;
+  } else if (source.columns_ != output_.columns_) {
+    throw std::runtime_error("rolling_operator::update: column mismatch");
+  }
+  if (source.rows() < consumed_) {
+    throw std::runtime_error("rolling_operator::update: source has fewer rows than already consumed");
+  }
+
+  const std::size_t k = output_.cols();
+  for (std::size_t r = consumed_; r < source.rows(); ++r) {
+    const std::size_t slot = r % window_;
+    double* cell = &ring_[slot * k];
+    const std::vector<double>& row = source.data_[r];
+    for (std::size_t c = 0; c < k; ++c) {
+      if (r >= window_) {
+        const double old = cell[c];
+        if (old == old) {
+          sums_[c] -= old;
+          sums_sq_[c] -= old * old;
+          --valid_counts_[c];
+        }
+      }
+      const double value = row[c];
+      if (value == value) {
+        sums_[c] += value;
+        sums_sq_[c] += value * value;
+        ++valid_counts_[c];
+      }
+      cell[c] = value;
+    }
+    if (slot + 1 == window_) resum();
+    if (r + 1 >= window_) {
+      std::vector<double> out_row(k);
+      for (std::size_t c = 0; c < k; ++c) out_row[c] = result(c);
+      output_.append_row(source.index_[r], out_row);
+    }
+  }
+  consumed_ = source.rows();
+  return output_;
+}
+
+template <typename IndexT>
+void RollingOperator<IndexT>::resum() {
+  const std::size_t k = sums_.size();
+  std::fill(sums_.begin(), sums_.end(), 0.0);
+  std::fill(sums_sq_.begin(), sums_sq_.end(), 0.0);
+  for (std::size_t slot = 0; slot < window_; ++slot) {
+    const double* cell = &ring_[slot * k];
+    for (std::size_t c = 0; c < k; ++c) {
+      const double value = cell[c];
+      if (value == value) {
+        sums_[c] += value;
+        sums_sq_[c] += value * value;
+      }
+    }
+  }
+}
+
+template <typename IndexT>
+double RollingOperator<IndexT>::result(std::size_t c) const {
+  if (valid_counts_[c] != window_) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  const double n = static_cast<double>(window_);
+  switch (statistic_) {
+    case RollingStatistic::mean:
+      return sums_[c] / n;
+    case RollingStatistic::rms:
+      return std::sqrt(sums_sq_[c] / n);
+    case RollingStatistic::std: {
+      if (window_ == 1) return 0.0;
+      const double mean = sums_[c] / n;
+      double variance = (sums_sq_[c] - sums_[c] * mean) / (n - 1.0);
+      return (variance > 0.0) ? std::sqrt(variance) : 0.0;
+    }
+  }
+  return std::numeric_limits<double>::quiet_NaN();
+}
+
+// Streaming counterpart of exponential_moving_average: update() smooths only
+// the rows appended to source since the previous call.
+template <typename IndexT>
+class EmaOperator {
+ public:
+  explicit EmaOperator(double alpha);
+
+  const DataFrame<IndexT>& update(const DataFrame<IndexT>& source);
+  const DataFrame<IndexT>& output() const { return output_; }
+  std::size_t consumed() const { return consumed_; }
+
+ private:
+  double alpha_;
+  std::size_t consumed_ = 0;
+  bool initialized_ = false;
+  std::vector<double> ema_;
+  std::vector<bool> has_ema_;
+  DataFrame<IndexT> output_;
+};
+
+template <typename IndexT>
+EmaOperator<IndexT>::EmaOperator(double alpha) : alpha_(alpha) {
+  if (!(alpha > 0.0) || !(alpha < 1.0)) {
+    throw std::runtime_error("ema_operator: alpha must be in (0,1)");
+  }
+}
+
+template <typename IndexT>
+const DataFrame<IndexT>& EmaOperator<IndexT>::update(const DataFrame<IndexT>& source) {
+  if (!initialized_) {
+    output_.columns_ = source.columns_;
+    output_.index_name_ = source.index_name_;
+    ema_.assign(source.cols(), std::numeric_limits<double>::quiet_NaN());
+    has_ema_.assign(source.cols(), false);
+    initialized_ = true;
+  } else if (source.columns_ != output_.columns_) {
+    throw std::runtime_error("ema_operator::update: column mismatch");
+  }
+  if (source.rows() < consumed_) {
+    throw std::runtime_error("ema_operator::update: source has fewer rows than already consumed");
+  }
+
+  const std::size_t k = output_.cols();
+  std::vector<double> out_row(k);
+  for (std::size_t r = consumed_; r < source.rows(); ++r) {
+    const std::vector<double>& row = source.data_[r];
+    for (std::size_t c = 0; c < k; ++c) {
+      const double value = row[c];
+      if (!(value == value)) {
+        out_row[c] = std::numeric_limits<double>::quiet_NaN();
+        continue;
+      }
+      if (!has_ema_[c]) {
+        ema_[c] = value;
+        has_ema_[c] = true;
+      } else {
+        ema_[c] = alpha_ * value + (1.0 - alpha_) * ema_[c];
+      }
+      out_row[c] = ema_[c];
+    }
+    output_.append_row(source.index_[r], out_row);
+  }
+  consumed_ = source.rows();
+  return output_;
+}
+
 using IntDataFrame = DataFrame<int>;
 using StringDataFrame = DataFrame<std::string>;
 
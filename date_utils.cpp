@@ -103,6 +103,55 @@ bool operator>=(const DateTime& lhs, const DateTime& rhs) {
   return !(lhs < rhs);
 }
 
+// Civil-date <-> day-count conversion after Howard Hinnant's days_from_civil.
+long long days_since_epoch(const Date& date) {
+  const long long m = static_cast<long long>(date.month);
+  const long long d = static_cast<long long>(date.day);
+  const long long y = static_cast<long long>(date.year) - (m <= 2 ? 1 : 0);
+  const long long era = (y >= 0 ? y : y - 399) / 400;
+  const long long yoe = y - era * 400;
+  const long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+Date date_from_days(long long days) {
+  const long long z = days + 719468;
+  const long long era = (z >= 0 ? z : z - 146096) / 146097;
+  const long long doe = z - era * 146097;
+  const long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const long long mp = (5 * doy + 2) / 153;
+  const long long d = doy - (153 * mp + 2) / 5 + 1;
+  const long long m = mp < 10 ? mp + 3 : mp - 9;
+  const long long y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+  return Date(static_cast<int>(y), static_cast<unsigned>(m), static_cast<unsigned>(d));
+}
+
+long long seconds_since_epoch(const DateTime& datetime) {
+  const long long days =
+      days_since_epoch(Date(datetime.year, datetime.month, datetime.day));
+  return days * 86400 + static_cast<long long>(datetime.hour) * 3600 +
+         static_cast<long long>(datetime.minute) * 60 +
+         static_cast<long long>(datetime.second);
+}
+
+DateTime datetime_from_seconds(long long seconds) {
+  long long days = seconds / 86400;
+  long long rem = seconds % 86400;
+  if (rem < 0) {
+    rem += 86400;
+    --days;
+  }
+  const Date date = date_from_days(days);
+  return DateTime(date.year,
+                  date.month,
+                  date.day,
+                  static_cast<unsigned>(rem / 3600),
+                  static_cast<unsigned>((rem % 3600) / 60),
+                  static_cast<unsigned>(rem % 60));
+}
+
 std::ostream& operator<<(std::ostream& os, const Date& value) {
   os << io::format_iso_date(value);
   return os;
@@ -50,6 +50,26 @@ bool operator>=(const DateTime& lhs, const DateTime& rhs);
 std::ostream& operator<<(std::ostream& os, const Date& value);
 std::ostream& operator<<(std::ostream& os, const DateTime& value);
 
+// Fixed-length span of time in whole seconds (no calendar months/years).
+struct Duration {
+  long long seconds = 0;
+
+  Duration() = default;
+  explicit Duration(long long s) : seconds(s) {}
+
+  static Duration from_seconds(long long s) { return Duration(s); }
+  static Duration from_minutes(long long m) { return Duration(m * 60); }
+  static Duration from_hours(long long h) { return Duration(h * 3600); }
+  static Duration from_days(long long d) { return Duration(d * 86400); }
+};
+
+// Conversions to and from a linear time axis (days or seconds since
+// 1970-01-01, proleptic Gregorian calendar, no time zone adjustment).
+long long days_since_epoch(const Date& date);
+Date date_from_days(long long days);
+long long seconds_since_epoch(const DateTime& datetime);
+DateTime datetime_from_seconds(long long seconds);
+
 namespace io {
 
 Date parse_iso_date(const std::string& iso_date);
@@ -0,0 +1,59 @@
+#ifndef DATAFRAME_PARALLEL_H
+#define DATAFRAME_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace df {
+namespace detail {
+
+// Splits [0, count) into contiguous chunks of at least min_chunk items and runs
+// func(begin, end) on each chunk from its own thread. Small workloads run inline;
+// the first exception thrown by any chunk is rethrown after all chunks finish.
+template <typename Func>
+void parallel_for(std::size_t count, Func func, std::size_t min_chunk = 1) {
+  if (count == 0) return;
+  if (min_chunk == 0) min_chunk = 1;
+  std::size_t workers = static_cast<std::size_t>(std::thread::hardware_concurrency());
+  if (workers == 0) workers = 1;
+  workers = std::min(workers, (count + min_chunk - 1) / min_chunk);
+  if (workers <= 1) {
+    func(std::size_t{0}, count);
+    return;
+  }
+
+  const std::size_t chunk = (count + workers - 1) / workers;
+  std::vector<std::exception_ptr> errors(workers);
+  std::vector<std::thread> threads;
+  threads.reserve(workers);
+  for (std::size_t w = 0; w < workers; ++w) {
+    const std::size_t begin = w * chunk;
+    const std::size_t end = std::min(count, begin + chunk);
+    if (begin >= end) break;
+    auto task = [&func, &errors, w, begin, end]() {
+      try {
+        func(begin, end);
+      } catch (...) {
+        errors[w] = std::current_exception();
+      }
+    };
+    try {
+      threads.emplace_back(task);
+    } catch (const std::system_error&) {
+      task();  // no thread available; finish this chunk on the caller
+    }
+  }
+  for (auto& thread : threads) thread.join();
+  for (const auto& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+}  // namespace detail
+}  // namespace df
+
+#endif
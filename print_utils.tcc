@@ -1,52 +1,144 @@
 #ifndef DATAFRAME_PRINT_UTILS_TCC
 #define DATAFRAME_PRINT_UTILS_TCC
 
+#include <charconv>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <optional>
 #include <sstream>
+#include <string_view>
+#include <type_traits>
 
 namespace df {
 namespace print {
 
+// Buffered text formatting for the printers below: rows are rendered with
+// std::to_chars into one string that is written to std::cout in a single call,
+// instead of streaming every value through iostream manipulators. Output is
+// byte-for-byte what the equivalent setw/fixed/scientific stream code prints.
+namespace text {
+
+// Right-aligns text in a field of at least width characters, like std::setw.
+inline void append_padded(std::string& out, std::string_view value, int width) {
+  if (static_cast<int>(value.size()) < width) {
+    out.append(static_cast<std::size_t>(width) - value.size(), ' ');
+  }
+  out.append(value.data(), value.size());
+}
+
+inline void append_double(std::string& out,
+                          double value,
+                          int precision,
+                          bool scientific,
+                          int width) {
+  char buffer[512];
+  const auto format = scientific ? std::chars_format::scientific : std::chars_format::fixed;
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, format, precision);
+  if (result.ec != std::errc()) {
+    std::ostringstream fallback;
+    if (scientific) {
+      fallback << std::scientific;
+    } else {
+      fallback << std::fixed;
+    }
+    fallback << std::setprecision(precision) << value;
+    append_padded(out, fallback.str(), width);
+    return;
+  }
+  append_padded(out, std::string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)), width);
+}
+
+inline void append_fixed(std::string& out, double value, int precision, int width) {
+  append_double(out, value, precision, false, width);
+}
+
+inline void append_integer(std::string& out, long long value, int width) {
+  char buffer[32];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  append_padded(out, std::string_view(buffer, static_cast<std::size_t>(result.ptr - buffer)), width);
+}
+
+// print_frame's value rule: fixed notation, switching to scientific for
+// magnitudes >= 10000 or < 0.01 (zero always prints in fixed notation).
+inline void append_frame_value(std::string& out, double value, int precision, int width) {
+  if (std::fabs(value) >= 10000.0 || std::fabs(value) < 0.01) {
+    if (value == 0.0) {
+      append_fixed(out, 0.0, precision, width);
+    } else {
+      append_double(out, value, precision, true, width);
+    }
+  } else {
+    append_fixed(out, value, precision, width);
+  }
+}
+
+// A precision >= 0 prints floating-point indexes in fixed notation with that
+// many decimals, as print_frame's stream did; otherwise they use the default
+// stream formatting.
+template <typename IndexT>
+void append_index(std::string& out, const IndexT& value, int width, int precision = -1) {
+  if constexpr (std::is_same_v<IndexT, Date>) {
+    append_padded(out, io::format_iso_date(value), width);
+  } else if constexpr (std::is_same_v<IndexT, DateTime>) {
+    append_padded(out, io::format_iso_datetime(value), width);
+  } else if constexpr (std::is_same_v<IndexT, std::string>) {
+    append_padded(out, value, width);
+  } else if constexpr (std::is_integral_v<IndexT>) {
+    append_integer(out, static_cast<long long>(value), width);
+  } else if constexpr (std::is_floating_point_v<IndexT>) {
+    if (precision >= 0) {
+      append_fixed(out, static_cast<double>(value), precision, width);
+    } else {
+      std::ostringstream oss;
+      oss << value;
+      append_padded(out, oss.str(), width);
+    }
+  } else {
+    std::ostringstream oss;
+    oss << value;
+    append_padded(out, oss.str(), width);
+  }
+}
+
+template <typename IndexT>
+std::string index_string(const IndexT& value) {
+  std::string out;
+  append_index(out, value, 0);
+  return out;
+}
+
+inline void write(const std::string& out) {
+  std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+
+}  // namespace text
+
 template <typename IndexT>
 void print_column_summary(const DataFrame<IndexT>& frame) {
   const int label_width = 10;
   const int value_width = 16;
   static const std::vector<std::string> headers = {"n", "mean", "sd", "skew",
                                                    "ex_kurtosis", "min", "max"};
-  std::cout << "\ncolumn summary statistics\n";
-  std::cout << std::setw(label_width) << "column";
+  // Rows of column_stats_dataframe: n, median, mean, sd, skew, ex_kurtosis, min, max.
+  static const std::size_t stat_rows[] = {2, 3, 4, 5, 6, 7};
+  const auto stats_frame = frame.column_stats_dataframe();
+
+  std::string out = "\ncolumn summary statistics\n";
+  text::append_padded(out, "column", label_width);
   for (const auto& h : headers) {
-    std::cout << std::setw(value_width) << h;
+    text::append_padded(out, h, value_width);
   }
-  std::cout << '\n';
-
-  auto old_flags = std::cout.flags();
-  auto old_precision = std::cout.precision();
-  std::cout << std::fixed << std::setprecision(6);
-
+  out += '\n';
   for (std::size_t c = 0; c < frame.cols(); ++c) {
-    std::vector<double> values;
-    values.reserve(frame.rows());
-    for (std::size_t r = 0; r < frame.rows(); ++r) {
-      values.push_back(frame.value(r, c));
+    text::append_padded(out, frame.columns()[c], label_width);
+    text::append_integer(out, std::llround(stats_frame.value(0, c)), value_width);
+    for (std::size_t row : stat_rows) {
+      text::append_fixed(out, stats_frame.value(row, c), 6, value_width);
     }
-    stats::SummaryStats summary = stats::summary_stats(values);
-    std::cout << std::setw(label_width) << frame.columns()[c];
-    std::cout << std::setw(value_width) << summary.n;
-    std::cout << std::setw(value_width) << summary.mean;
-    std::cout << std::setw(value_width) << summary.sd;
-    std::cout << std::setw(value_width) << summary.skew;
-    std::cout << std::setw(value_width) << summary.ex_kurtosis;
-    std::cout << std::setw(value_width) << summary.min;
-    std::cout << std::setw(value_width) << summary.max;
-    std::cout << '\n';
+    out += '\n';
   }
-
-  std::cout.flags(old_flags);
-  std::cout.precision(old_precision);
+  text::write(out);
 }
 
 template <typename IndexT>
@@ -55,56 +147,46 @@ void print_column_summary_with_missing(const DataFrame<IndexT>& frame,
                                        int precision) {
   const int label_width = 12;
   const int value_width = 14;
-  std::cout << "\n" << title << "\n";
-  std::cout << std::setw(label_width) << "column" << std::setw(label_width)
-            << "first_idx" << std::setw(label_width) << "last_idx"
-            << std::setw(value_width) << "n" << std::setw(value_width)
-            << "median" << std::setw(value_width) << "mean" << std::setw(value_width) << "sd" << std::setw(value_width)
-            << "skew" << std::setw(value_width) << "ex_kurt"
-            << std::setw(value_width) << "min" << std::setw(value_width)
-            << "max" << '\n';
-
-  auto index_to_string = [](const IndexT& idx) {
-    std::ostringstream oss;
-    oss << idx;
-    return oss.str();
-  };
+  static const std::vector<std::string> headers = {"n", "median", "mean", "sd", "skew",
+                                                   "ex_kurt", "min", "max"};
+  const auto stats_frame = frame.column_stats_dataframe();
 
-  auto old_flags = std::cout.flags();
-  auto old_precision = std::cout.precision();
-  std::cout << std::fixed << std::setprecision(precision);
+  std::string out = "\n" + title + "\n";
+  text::append_padded(out, "column", label_width);
+  text::append_padded(out, "first_idx", label_width);
+  text::append_padded(out, "last_idx", label_width);
+  for (const auto& h : headers) {
+    text::append_padded(out, h, value_width);
+  }
+  out += '\n';
 
   for (std::size_t c = 0; c < frame.cols(); ++c) {
-    std::vector<double> values;
-    values.reserve(frame.rows());
     std::string first_idx = "NA";
     std::string last_idx = "NA";
     for (std::size_t r = 0; r < frame.rows(); ++r) {
-      double v = frame.value(r, c);
+      const double v = frame.value(r, c);
       if (v == v) {
-        if (first_idx == "NA") first_idx = index_to_string(frame.index()[r]);
-        last_idx = index_to_string(frame.index()[r]);
-        values.push_back(v);
+        first_idx = text::index_string(frame.index()[r]);
+        break;
       }
     }
-    stats::SummaryStats summary = stats::summary_stats(values);
-    double median = detail::compute_median(values);
-    if (summary.n <= 0) {
-      first_idx = "NA";
-      last_idx = "NA";
+    for (std::size_t r = frame.rows(); r-- > 0;) {
+      const double v = frame.value(r, c);
+      if (v == v) {
+        last_idx = text::index_string(frame.index()[r]);
+        break;
+      }
+    }
+    text::append_padded(out, frame.columns()[c], label_width);
+    text::append_padded(out, first_idx, label_width);
+    text::append_padded(out, last_idx, label_width);
+    text::append_integer(out, std::llround(stats_frame.value(0, c)), value_width);
+    for (std::size_t row = 1; row < stats_frame.rows(); ++row) {
+      text::append_fixed(out, stats_frame.value(row, c), precision, value_width);
     }
-    std::cout << std::setw(label_width) << frame.columns()[c]
-              << std::setw(label_width) << first_idx << std::setw(label_width)
-              << last_idx << std::setw(value_width) << summary.n
-              << std::setw(value_width) << median << std::setw(value_width)
-              << summary.mean << std::setw(value_width) << summary.sd
-              << std::setw(value_width) << summary.skew << std::setw(value_width)
-              << summary.ex_kurtosis << std::setw(value_width) << summary.min
-              << std::setw(value_width) << summary.max << '\n';
+    out += '\n';
   }
-
-  std::cout.flags(old_flags);
-  std::cout.precision(old_precision);
+  text::write(out);
 }
 
 template <typename IndexT>
@@ -169,22 +251,22 @@ void print_column_autocorrelations(const DataFrame<IndexT>& frame,
   auto old_precision = std::cout.precision();
   std::cout << std::fixed << std::setprecision(precision);
 
+  auto acf = frame.autocorrelation_matrix(static_cast<std::size_t>(max_lag));
+  std::vector<std::size_t> valid_counts(frame.cols(), 0);
+  for (std::size_t r = 0; r < frame.rows(); ++r) {
+    for (std::size_t c = 0; c < frame.cols(); ++c) {
+      double v = frame.value(r, c);
+      if (v == v) ++valid_counts[c];
+    }
+  }
   for (int lag = 1; lag <= max_lag; ++lag) {
     std::cout << std::setw(label_width) << lag;
     for (std::size_t c = 0; c < frame.cols(); ++c) {
-      std::vector<double> values;
-      values.reserve(frame.rows());
-      for (std::size_t r = 0; r < frame.rows(); ++r) {
-        double v = frame.value(r, c);
-        if (v == v) values.push_back(v);
-      }
-      if (static_cast<int>(values.size()) <= lag) {
+      if (valid_counts[c] <= static_cast<std::size_t>(lag)) {
         std::cout << std::setw(value_width) << 0.0;
         continue;
       }
-      auto acfs = stats::autocorrelations(values, lag);
-      double ac = (lag - 1 < static_cast<int>(acfs.size())) ? acfs[lag - 1] : 0.0;
-      std::cout << std::setw(value_width) << ac;
+      std::cout << std::setw(value_width) << acf.value(static_cast<std::size_t>(lag - 1), c);
     }
     std::cout << '\n';
   }
@@ -207,12 +289,20 @@ void print_column_percentiles(const DataFrame<IndexT>& frame,
 }
 
 template <typename IndexT>
-void print_columns_header(const DataFrame<IndexT>& frame) {
-  std::cout << std::setw(12) << frame.index_name();
+void append_columns_header(std::string& out, const DataFrame<IndexT>& frame) {
+  text::append_padded(out, frame.index_name(), 12);
   for (const auto& name : frame.columns()) {
-    std::cout << ' ' << std::setw(12) << name;
+    out += ' ';
+    text::append_padded(out, name, 12);
   }
-  std::cout << '\n';
+  out += '\n';
+}
+
+template <typename IndexT>
+void print_columns_header(const DataFrame<IndexT>& frame) {
+  std::string out;
+  append_columns_header(out, frame);
+  text::write(out);
 }
 
 template <typename IndexT>
@@ -220,53 +310,44 @@ void print_frame(const DataFrame<IndexT>& frame,
                  const std::string& title,
                  bool include_summary,
                  int precision) {
-  std::cout << "\n" << title << '\n';
-  print_columns_header(frame);
   const std::size_t total = frame.rows();
   const std::size_t max_print = 5;
   const bool use_window = total > 2 * max_print;
-  auto old_flags = std::cout.flags();
-  auto old_precision = std::cout.precision();
-  std::cout << std::fixed << std::setprecision(precision);
+  const std::size_t shown = use_window ? 2 * max_print : total;
+
+  std::string out;
+  out.reserve(title.size() + (shown + 2) * (frame.cols() + 1) * 13 + 8);
+  out += '\n';
+  out += title;
+  out += '\n';
+  append_columns_header(out, frame);
 
-  auto print_row = [&](std::size_t r) {
-    std::cout << std::setw(12) << frame.index()[r];
+  auto append_row = [&](std::size_t r) {
+    text::append_index(out, frame.index()[r], 12, precision);
     bool force_int = false;
     if constexpr (std::is_same_v<IndexT, std::string>) {
       force_int = (frame.index()[r] == "n");
     }
     for (std::size_t c = 0; c < frame.cols(); ++c) {
-      std::cout << ' ' << std::setw(12);
-      double value = frame.value(r, c);
+      out += ' ';
+      const double value = frame.value(r, c);
       if (force_int) {
-        std::cout << static_cast<long long>(std::llround(value));
+        text::append_integer(out, std::llround(value), 12);
       } else {
-        if (std::fabs(value) >= 10000.0 || std::fabs(value) < 0.01) {
-          if (value == 0.0) {
-            std::cout << 0.0;
-          } else {
-            std::cout.setf(std::ios::scientific, std::ios::floatfield);
-            std::cout << value;
-            std::cout.setf(std::ios::fixed, std::ios::floatfield);
-          }
-        } else {
-          std::cout << value;
-        }
+        text::append_frame_value(out, value, precision, 12);
       }
     }
-    std::cout << '\n';
+    out += '\n';
   };
 
   if (!use_window) {
-    for (std::size_t r = 0; r < total; ++r) print_row(r);
+    for (std::size_t r = 0; r < total; ++r) append_row(r);
   } else {
-    for (std::size_t r = 0; r < max_print; ++r) print_row(r);
-    std::cout << "..." << '\n';
-    for (std::size_t r = total - max_print; r < total; ++r) print_row(r);
+    for (std::size_t r = 0; r < max_print; ++r) append_row(r);
+    out += "...\n";
+    for (std::size_t r = total - max_print; r < total; ++r) append_row(r);
   }
-
-  std::cout.flags(old_flags);
-  std::cout.precision(old_precision);
+  text::write(out);
 
   if (include_summary) {
     print_column_summary(frame);
@@ -0,0 +1,185 @@
+#ifndef DATAFRAME_RING_BUFFER_FRAME_H
+#define DATAFRAME_RING_BUFFER_FRAME_H
+
+#include "dataframe.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace df {
+
+// Fixed-capacity circular frame for live feeds: one writer thread appends rows
+// into preallocated slots, any number of reader threads take snapshots as
+// ordinary DataFrames without blocking the writer.
+//
+// Each slot carries a sequence word (odd while being written, 2*row+2 once
+// row `row` is complete). Readers copy a slot and accept it only if the word
+// matches before and after the copy; rows the writer lapped during the copy
+// are dropped, so a snapshot is always a contiguous, consistent run of the
+// most recent rows. All shared cells are relaxed atomics, so the protocol has
+// no data races. append() must only be called from one thread at a time.
+template <typename IndexT = DateTime>
+class RingBufferFrame {
+  static_assert(std::is_trivially_copyable_v<IndexT>,
+                "RingBufferFrame requires a trivially copyable index type");
+
+ public:
+  RingBufferFrame(std::size_t capacity,
+                  const std::vector<std::string>& columns,
+                  const std::string& index_name = "index");
+
+  void append(const IndexT& index_value, const double* values, std::size_t count);
+  void append(const IndexT& index_value, const std::vector<double>& values);
+
+  DataFrame<IndexT> snapshot(std::size_t max_rows = 0) const;
+
+  std::size_t capacity() const { return capacity_; }
+  std::size_t cols() const { return columns_.size(); }
+  const std::vector<std::string>& columns() const { return columns_; }
+  std::uint64_t total_appended() const { return head_.load(std::memory_order_acquire); }
+  std::size_t size() const;
+
+ private:
+  static constexpr std::size_t kIndexWords = (sizeof(IndexT) + 7) / 8;
+
+  std::size_t capacity_;
+  std::vector<std::string> columns_;
+  std::string index_name_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> sequence_;
+  std::unique_ptr<std::atomic<std::uint64_t>[]> index_words_;
+  std::unique_ptr<std::atomic<double>[]> values_;
+  std::atomic<std::uint64_t> head_{0};
+};
+
+template <typename IndexT>
+RingBufferFrame<IndexT>::RingBufferFrame(std::size_t capacity,
+                                         const std::vector<std::string>& columns,
+                                         const std::string& index_name)
+    : capacity_(capacity), columns_(columns), index_name_(index_name) {
+  if (capacity == 0) {
+    throw std::runtime_error("ring_buffer_frame: capacity must be positive");
+  }
+  if (columns.empty()) {
+    throw std::runtime_error("ring_buffer_frame: at least one column is required");
+  }
+  sequence_.reset(new std::atomic<std::uint64_t>[capacity_]);
+  index_words_.reset(new std::atomic<std::uint64_t>[capacity_ * kIndexWords]);
+  values_.reset(new std::atomic<double>[capacity_ * columns_.size()]);
+  for (std::size_t i = 0; i < capacity_; ++i) {
+    sequence_[i].store(0, std::memory_order_relaxed);
+  }
+  for (std::size_t i = 0; i < capacity_ * kIndexWords; ++i) {
+    index_words_[i].store(0, std::memory_order_relaxed);
+  }
+  for (std::size_t i = 0; i < capacity_ * columns_.size(); ++i) {
+    values_[i].store(0.0, std::memory_order_relaxed);
+  }
+}
+
+template <typename IndexT>
+void RingBufferFrame<IndexT>::append(const IndexT& index_value,
+                                     const double* values,
+                                     std::size_t count) {
+  const std::size_t k = columns_.size();
+  if (count != k) {
+    throw std::runtime_error("ring_buffer_frame::append: value count mismatch");
+  }
+  if (!values) {
+    throw std::runtime_error("ring_buffer_frame::append: values pointer is null");
+  }
+  const std::uint64_t row = head_.load(std::memory_order_relaxed);
+  const std::size_t slot = static_cast<std::size_t>(row % capacity_);
+
+  sequence_[slot].store(2 * row + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::uint64_t words[kIndexWords] = {};
+  std::memcpy(words, &index_value, sizeof(IndexT));
+  std::atomic<std::uint64_t>* index_cell = &index_words_[slot * kIndexWords];
+  for (std::size_t w = 0; w < kIndexWords; ++w) {
+    index_cell[w].store(words[w], std::memory_order_relaxed);
+  }
+  std::atomic<double>* value_cell = &values_[slot * k];
+  for (std::size_t c = 0; c < k; ++c) {
+    value_cell[c].store(values[c], std::memory_order_relaxed);
+  }
+
+  sequence_[slot].store(2 * row + 2, std::memory_order_release);
+  head_.store(row + 1, std::memory_order_release);
+}
+
+template <typename IndexT>
+void RingBufferFrame<IndexT>::append(const IndexT& index_value,
+                                     const std::vector<double>& values) {
+  append(index_value, values.data(), values.size());
+}
+
+template <typename IndexT>
+std::size_t RingBufferFrame<IndexT>::size() const {
+  const std::uint64_t head = head_.load(std::memory_order_acquire);
+  return static_cast<std::size_t>(std::min<std::uint64_t>(head, capacity_));
+}
+
+template <typename IndexT>
+DataFrame<IndexT> RingBufferFrame<IndexT>::snapshot(std::size_t max_rows) const {
+  const std::size_t k = columns_.size();
+  const std::uint64_t head = head_.load(std::memory_order_acquire);
+  std::uint64_t available = std::min<std::uint64_t>(head, capacity_);
+  if (max_rows > 0) available = std::min<std::uint64_t>(available, max_rows);
+  const std::uint64_t first = head - available;
+
+  std::vector<IndexT> indices;
+  std::vector<double> flat;
+  indices.reserve(static_cast<std::size_t>(available));
+  flat.reserve(static_cast<std::size_t>(available) * k);
+
+  std::vector<double> row_values(k);
+  for (std::uint64_t row = first; row < head; ++row) {
+    const std::size_t slot = static_cast<std::size_t>(row % capacity_);
+    const std::uint64_t expected = 2 * row + 2;
+    bool valid = sequence_[slot].load(std::memory_order_acquire) == expected;
+    if (valid) {
+      std::uint64_t words[kIndexWords];
+      const std::atomic<std::uint64_t>* index_cell = &index_words_[slot * kIndexWords];
+      for (std::size_t w = 0; w < kIndexWords; ++w) {
+        words[w] = index_cell[w].load(std::memory_order_relaxed);
+      }
+      const std::atomic<double>* value_cell = &values_[slot * k];
+      for (std::size_t c = 0; c < k; ++c) {
+        row_values[c] = value_cell[c].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      valid = sequence_[slot].load(std::memory_order_relaxed) == expected;
+      if (valid) {
+        IndexT index_value;
+        std::memcpy(&index_value, words, sizeof(IndexT));
+        indices.push_back(index_value);
+        flat.insert(flat.end(), row_values.begin(), row_values.end());
+        continue;
+      }
+    }
+    // The writer lapped this slot, so every earlier row is gone as well;
+    // restart the run to keep the snapshot contiguous.
+    indices.clear();
+    flat.clear();
+  }
+
+  DataFrame<IndexT> out = DataFrame<IndexT>::from_vectors({}, columns_, {});
+  out.set_index_name(index_name_);
+  out.reserve_rows(indices.size());
+  for (std::size_t r = 0; r < indices.size(); ++r) {
+    out.append_row(indices[r], &flat[r * k], k);
+  }
+  return out;
+}
+
+}  // namespace df
+
+#endif
@@ -0,0 +1,673 @@
+#ifndef DATAFRAME_ROW_GROUP_FILE_H
+#define DATAFRAME_ROW_GROUP_FILE_H
+
+#include "dataframe.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace df {
+
+// Binary file split into row groups with a zone map per group: the index
+// range covered and, per column, min, max and NaN count. Each group is an
+// ordinary to_binary snapshot (compressed by default), so readers seek
+// straight to the groups a query can match and never read the others.
+//
+// Layout: "DFRGF2", then one or more segments. A segment is a run of group
+// snapshots followed by a footer: the end offset of the previous segment (0
+// for the first), the index and column names, and each group's offset,
+// length, row count and zone map, closed by the footer length (u64), an
+// FNV-1a checksum of the footer (u64) and "DFRGF2". Opening a file reads only
+// the footers, walking back from the end.
+//
+// The file doubles as an append-only log: append() writes the new rows as a
+// new segment after the current end of file, so earlier bytes are never
+// rewritten and each append costs only its own rows and footer. Many small
+// appends leave many small groups; compact() rewrites the file as one
+// segment of full groups once segment_count() or group_count() make that
+// worthwhile.
+//
+// An append interrupted by a crash leaves a torn tail with no intact footer.
+// Opening the file then scans back to the last footer whose checksum holds
+// and reads the segments up to there; torn_bytes() reports what was skipped.
+// The next append chains its segment past the torn bytes, and compact()
+// drops them. A file whose first write never committed a segment, down to
+// an empty or partly written magic, is simply rewritten by the next append.
+//
+// A reader keeps the file open and sees the segments present when it was
+// opened: later appends stay invisible until the file is reopened, and on
+// POSIX systems it keeps reading the old file after a compaction replaces it.
+// Const reads may run from several threads at once: each takes a mutex only
+// while it copies a group's bytes off the shared stream, and decodes outside
+// it.
+template <typename IndexT>
+class RowGroupFile {
+  static_assert(detail::is_orderable_index<IndexT>::value,
+                "RowGroupFile requires an orderable index type");
+
+ public:
+  struct ColumnStats {
+    double min = std::numeric_limits<double>::quiet_NaN();  // NaN when every value is NaN
+    double max = std::numeric_limits<double>::quiet_NaN();
+    std::size_t nan_count = 0;
+  };
+
+  struct Group {
+    std::uint64_t offset = 0;
+    std::uint64_t length = 0;
+    std::size_t rows = 0;
+    IndexT index_min{};
+    IndexT index_max{};
+    std::vector<ColumnStats> columns;
+  };
+
+  static void write(const DataFrame<IndexT>& frame,
+                    const std::string& path,
+                    std::size_t group_rows = 65536,
+                    BinaryCompression compression = BinaryCompression::automatic);
+  // Appends batch as new groups; creates the file when it does not exist.
+  static void append(const DataFrame<IndexT>& batch,
+                     const std::string& path,
+                     std::size_t group_rows = 65536,
+                     BinaryCompression compression = BinaryCompression::automatic);
+  // Rewrites the file with groups of group_rows rows and a single footer,
+  // streaming one group at a time; the result replaces path. append and
+  // compact on one path must come from a single writer; compact throws
+  // instead of replacing the file if it changed size while being rewritten.
+  static void compact(const std::string& path,
+                      std::size_t group_rows = 65536,
+                      BinaryCompression compression = BinaryCompression::automatic);
+
+  explicit RowGroupFile(const std::string& path);
+
+  const std::string& index_name() const { return index_name_; }
+  const std::vector<std::string>& columns() const { return columns_; }
+  std::size_t rows() const;
+  std::size_t group_count() const { return groups_.size(); }
+  const Group& group(std::size_t g) const { return groups_.at(g); }
+  // Number of write/append calls whose segments make up the file.
+  std::size_t segment_count() const { return segment_count_; }
+  // Bytes after the last complete segment, left by an interrupted append.
+  std::uint64_t torn_bytes() const { return file_size_ - data_end_; }
+
+  // Groups whose index range overlaps [start, end] (or [start, end)); same
+  // bounds handling as DataFrame::slice_rows_range.
+  std::vector<std::size_t> groups_in_range(IndexT start, IndexT end, bool inclusive_end = true) const;
+  // Groups that may hold a value of column within [lower, upper].
+  std::vector<std::size_t> groups_between(const std::string& column, double lower, double upper) const;
+
+  DataFrame<IndexT> read_group(std::size_t g) const;
+  DataFrame<IndexT> read_groups(const std::vector<std::size_t>& groups) const;
+  DataFrame<IndexT> read_all() const;
+  // Last count rows, reading only the trailing groups that hold them.
+  DataFrame<IndexT> tail_rows(std::size_t count) const;
+  DataFrame<IndexT> slice_rows_range(IndexT start, IndexT end, bool inclusive_end = true) const;
+  // Rows where column lies within [lower, upper]; NaN never matches.
+  DataFrame<IndexT> filter_between(const std::string& column, double lower, double upper) const;
+
+ private:
+  static constexpr char kMagic[6] = {'D', 'F', 'R', 'G', 'F', '2'};
+
+  static Group write_group(std::ostream& output,
+                           const DataFrame<IndexT>& frame,
+                           std::size_t begin,
+                           std::size_t end,
+                           std::uint64_t offset,
+                           BinaryCompression compression);
+  static void write_footer(std::ostream& output,
+                           std::uint64_t previous_end,
+                           const std::string& index_name,
+                           const std::vector<std::string>& columns,
+                           const std::vector<Group>& groups);
+
+  static std::uint64_t footer_checksum(const std::string& footer);
+
+  DataFrame<IndexT> empty_frame() const;
+  std::size_t column_position(const std::string& column) const;
+  bool read_footer(std::uint64_t end, std::string& footer);
+  std::uint64_t last_segment_end();
+  std::uint64_t read_segment(std::uint64_t end, std::vector<Group>& groups);
+
+  mutable std::ifstream file_;
+  mutable std::mutex file_mutex_;
+  std::uint64_t file_size_ = 0;
+  std::uint64_t data_end_ = 0;
+  std::size_t segment_count_ = 0;
+  std::string index_name_;
+  std::vector<std::string> columns_;
+  std::vector<Group> groups_;
+};
+
+template <typename IndexT>
+typename RowGroupFile<IndexT>::Group RowGroupFile<IndexT>::write_group(std::ostream& output,
+                                                                       const DataFrame<IndexT>& frame,
+                                                                       std::size_t begin,
+                                                                       std::size_t end,
+                                                                       std::uint64_t offset,
+                                                                       BinaryCompression compression) {
+  const std::size_t k = frame.cols();
+  const auto& index = frame.index();
+  Group group;
+  group.offset = offset;
+  group.rows = end - begin;
+  group.index_min = index[begin];
+  group.index_max = index[begin];
+  group.columns.assign(k, ColumnStats{});
+
+  DataFrame<IndexT> chunk = DataFrame<IndexT>::from_vectors({}, frame.columns(), {});
+  chunk.set_index_name(frame.index_name());
+  chunk.reserve_rows(group.rows);
+  std::vector<double> row(k);
+  for (std::size_t r = begin; r < end; ++r) {
+    if (index[r] < group.index_min) group.index_min = index[r];
+    if (index[r] > group.index_max) group.index_max = index[r];
+    for (std::size_t c = 0; c < k; ++c) {
+      const double value = frame.value(r, c);
+      row[c] = value;
+      ColumnStats& stats = group.columns[c];
+      if (std::isnan(value)) {
+        ++stats.nan_count;
+      } else if (std::isnan(stats.min)) {
+        stats.min = value;
+        stats.max = value;
+      } else {
+        stats.min = std::min(stats.min, value);
+        stats.max = std::max(stats.max, value);
+      }
+    }
+    chunk.append_row(index[r], row.data(), k);
+  }
+
+  const std::streampos start = output.tellp();
+  chunk.to_binary(output, compression);
+  group.length = static_cast<std::uint64_t>(output.tellp() - start);
+  return group;
+}
+
+template <typename IndexT>
+void RowGroupFile<IndexT>::write_footer(std::ostream& output,
+                                        std::uint64_t previous_end,
+                                        const std::string& index_name,
+                                        const std::vector<std::string>& columns,
+                                        const std::vector<Group>& groups) {
+  std::ostringstream body;
+  detail::write_pod<std::uint64_t>(body, previous_end);
+  detail::write_string(body, index_name);
+  detail::write_pod<std::uint64_t>(body, static_cast<std::uint64_t>(columns.size()));
+  for (const auto& name : columns) {
+    detail::write_string(body, name);
+  }
+  detail::write_pod<std::uint64_t>(body, static_cast<std::uint64_t>(groups.size()));
+  for (const auto& group : groups) {
+    detail::write_pod<std::uint64_t>(body, group.offset);
+    detail::write_pod<std::uint64_t>(body, group.length);
+    detail::write_pod<std::uint64_t>(body, static_cast<std::uint64_t>(group.rows));
+    detail::write_index_value(body, group.index_min);
+    detail::write_index_value(body, group.index_max);
+    for (const auto& stats : group.columns) {
+      detail::write_pod(body, stats.min);
+      detail::write_pod(body, stats.max);
+      detail::write_pod<std::uint64_t>(body, static_cast<std::uint64_t>(stats.nan_count));
+    }
+  }
+  const std::string footer = body.str();
+  output.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+  detail::write_pod<std::uint64_t>(output, static_cast<std::uint64_t>(footer.size()));
+  detail::write_pod<std::uint64_t>(output, footer_checksum(footer));
+  output.write(kMagic, sizeof(kMagic));
+}
+
+template <typename IndexT>
+std::uint64_t RowGroupFile<IndexT>::footer_checksum(const std::string& footer) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (char byte : footer) {
+    hash ^= static_cast<unsigned char>(byte);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+template <typename IndexT>
+void RowGroupFile<IndexT>::write(const DataFrame<IndexT>& frame,
+                                 const std::string& path,
+                                 std::size_t group_rows,
+                                 BinaryCompression compression) {
+  if (group_rows == 0) {
+    throw std::runtime_error("row_group_file::write: group_rows must be positive");
+  }
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("row_group_file::write: unable to open output file");
+  }
+  file.write(kMagic, sizeof(kMagic));
+
+  std::vector<Group> groups;
+  std::uint64_t offset = sizeof(kMagic);
+  for (std::size_t begin = 0; begin < frame.rows(); begin += group_rows) {
+    const std::size_t end = std::min(frame.rows(), begin + group_rows);
+    groups.push_back(write_group(file, frame, begin, end, offset, compression));
+    offset += groups.back().length;
+  }
+  write_footer(file, 0, frame.index_name(), frame.columns(), groups);
+  if (!file.good()) {
+    throw std::runtime_error("row_group_file::write: failed while writing file");
+  }
+}
+
+template <typename IndexT>
+void RowGroupFile<IndexT>::append(const DataFrame<IndexT>& batch,
+                                  const std::string& path,
+                                  std::size_t group_rows,
+                                  BinaryCompression compression) {
+  if (group_rows == 0) {
+    throw std::runtime_error("row_group_file::append: group_rows must be positive");
+  }
+  {
+    std::ifstream probe(path, std::ios::binary);
+    if (!probe.is_open()) {
+      write(batch, path, group_rows, compression);
+      return;
+    }
+    // A crash before the first write flushed leaves fewer bytes than the
+    // magic, all of them a prefix of it; nothing was committed.
+    char head[sizeof(kMagic)];
+    probe.read(head, sizeof(head));
+    const std::size_t got = static_cast<std::size_t>(probe.gcount());
+    if (got < sizeof(kMagic) && std::memcmp(head, kMagic, got) == 0) {
+      probe.close();
+      write(batch, path, group_rows, compression);
+      return;
+    }
+  }
+  const RowGroupFile<IndexT> existing(path);
+  if (existing.segment_count_ == 0) {
+    // The write that created the file never finished; nothing was committed.
+    write(batch, path, group_rows, compression);
+    return;
+  }
+  if (existing.columns_ != batch.columns()) {
+    throw std::runtime_error("row_group_file::append: column mismatch");
+  }
+  if (batch.rows() == 0) return;
+
+  std::ofstream file(path, std::ios::binary | std::ios::app);
+  if (!file.is_open()) {
+    throw std::runtime_error("row_group_file::append: unable to open file");
+  }
+  std::vector<Group> groups;
+  std::uint64_t offset = existing.file_size_;
+  for (std::size_t begin = 0; begin < batch.rows(); begin += group_rows) {
+    const std::size_t end = std::min(batch.rows(), begin + group_rows);
+    std::ostringstream encoded;
+    Group group = write_group(encoded, batch, begin, end, offset, compression);
+    const std::string bytes = encoded.str();
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    offset += group.length;
+    groups.push_back(std::move(group));
+  }
+  std::ostringstream footer;
+  write_footer(footer, existing.data_end_, existing.index_name_, existing.columns_, groups);
+  const std::string bytes = footer.str();
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  file.flush();
+  if (!file.good()) {
+    throw std::runtime_error("row_group_file::append: failed while writing file");
+  }
+}
+
+template <typename IndexT>
+void RowGroupFile<IndexT>::compact(const std::string& path,
+                                   std::size_t group_rows,
+                                   BinaryCompression compression) {
+  if (group_rows == 0) {
+    throw std::runtime_error("row_group_file::compact: group_rows must be positive");
+  }
+  const std::string temp_path = path + ".compact";
+  std::uint64_t source_size = 0;
+  {
+    // Scoped so the source is closed before it is replaced.
+    const RowGroupFile<IndexT> source(path);
+    source_size = source.file_size_;
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      throw std::runtime_error("row_group_file::compact: unable to open temporary file");
+    }
+    file.write(kMagic, sizeof(kMagic));
+    std::vector<Group> groups;
+    std::uint64_t offset = sizeof(kMagic);
+    DataFrame<IndexT> pending = source.empty_frame();
+    auto flush = [&](std::size_t keep_below) {
+      std::size_t begin = 0;
+      while (pending.rows() - begin > keep_below) {
+        const std::size_t end = std::min(pending.rows(), begin + group_rows);
+        groups.push_back(write_group(file, pending, begin, end, offset, compression));
+        offset += groups.back().length;
+        begin = end;
+      }
+      pending = pending.tail_rows(pending.rows() - begin);
+    };
+    for (std::size_t g = 0; g < source.group_count(); ++g) {
+      pending.append_rows(source.read_group(g));
+      if (pending.rows() >= group_rows) flush(group_rows - 1);
+    }
+    flush(0);
+    write_footer(file, 0, source.index_name_, source.columns_, groups);
+    if (!file.good()) {
+      throw std::runtime_error("row_group_file::compact: failed while writing file");
+    }
+  }
+  {
+    // Rows appended while the copy was written would be lost by the rename.
+    std::ifstream current(path, std::ios::binary | std::ios::ate);
+    if (!current.is_open() || static_cast<std::uint64_t>(current.tellg()) != source_size) {
+      std::remove(temp_path.c_str());
+      throw std::runtime_error("row_group_file::compact: file changed during compaction");
+    }
+  }
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    // std::rename does not replace an existing file on every platform. Move
+    // the original aside first, so a failure (or crash) between the two
+    // renames leaves both copies on disk.
+    const std::string backup_path = path + ".bak";
+    std::remove(backup_path.c_str());
+    if (std::rename(path.c_str(), backup_path.c_str()) != 0) {
+      std::remove(temp_path.c_str());
+      throw std::runtime_error("row_group_file::compact: unable to replace file");
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+      std::rename(backup_path.c_str(), path.c_str());
+      throw std::runtime_error("row_group_file::compact: unable to replace file");
+    }
+    std::remove(backup_path.c_str());
+  }
+}
+
+template <typename IndexT>
+RowGroupFile<IndexT>::RowGroupFile(const std::string& path) : file_(path, std::ios::binary) {
+  if (!file_.is_open()) {
+    throw std::runtime_error("row_group_file: unable to open file");
+  }
+  file_.seekg(0, std::ios::end);
+  file_size_ = static_cast<std::uint64_t>(file_.tellg());
+  char magic[sizeof(kMagic)];
+  file_.seekg(0);
+  file_.read(magic, sizeof(magic));
+  if (!file_ || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("row_group_file: invalid file header");
+  }
+
+  data_end_ = last_segment_end();
+  std::vector<std::vector<Group>> segments;
+  std::uint64_t end = data_end_;
+  while (end != 0) {
+    segments.emplace_back();
+    end = read_segment(end, segments.back());
+  }
+  for (std::size_t s = segments.size(); s-- > 0;) {
+    groups_.insert(groups_.end(), segments[s].begin(), segments[s].end());
+  }
+}
+
+// Reads the footer of the segment ending at end; false when no intact footer
+// (matching magic, length in bounds and checksum) ends there.
+template <typename IndexT>
+bool RowGroupFile<IndexT>::read_footer(std::uint64_t end, std::string& footer) {
+  const std::uint64_t trailer = 2 * sizeof(std::uint64_t) + sizeof(kMagic);
+  if (end < sizeof(kMagic) + trailer || end > file_size_) return false;
+  std::uint64_t footer_length = 0;
+  std::uint64_t checksum = 0;
+  char magic[sizeof(kMagic)];
+  file_.clear();
+  file_.seekg(static_cast<std::streamoff>(end - trailer));
+  file_.read(reinterpret_cast<char*>(&footer_length), sizeof(footer_length));
+  file_.read(reinterpret_cast<char*>(&checksum), sizeof(checksum));
+  file_.read(magic, sizeof(magic));
+  if (!file_ || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      footer_length > end - trailer - sizeof(kMagic)) {
+    return false;
+  }
+  footer.assign(static_cast<std::size_t>(footer_length), '\0');
+  file_.seekg(static_cast<std::streamoff>(end - trailer - footer_length));
+  file_.read(footer.data(), static_cast<std::streamsize>(footer.size()));
+  return file_ && footer_checksum(footer) == checksum;
+}
+
+// End of the last complete segment: the end of file when its footer is intact,
+// otherwise the end of the nearest intact footer before it, found by scanning
+// back for the magic. 0 when no segment was ever completed.
+template <typename IndexT>
+std::uint64_t RowGroupFile<IndexT>::last_segment_end() {
+  std::string footer;
+  if (read_footer(file_size_, footer)) return file_size_;
+  constexpr std::uint64_t block = 65536;
+  std::vector<char> buffer;
+  std::uint64_t hi = file_size_;
+  while (hi > sizeof(kMagic)) {
+    const std::uint64_t lo = hi > block ? hi - block : 0;
+    buffer.resize(static_cast<std::size_t>(hi - lo));
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(lo));
+    file_.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file_) {
+      throw std::runtime_error("row_group_file: failed to read file");
+    }
+    for (std::size_t pos = buffer.size() - sizeof(kMagic) + 1; pos-- > 0;) {
+      if (std::memcmp(buffer.data() + pos, kMagic, sizeof(kMagic)) != 0) continue;
+      const std::uint64_t end = lo + pos + sizeof(kMagic);
+      if (end < file_size_ && read_footer(end, footer)) return end;
+    }
+    if (lo == 0) break;
+    // Overlap by one byte less than the magic so a match across blocks is
+    // found exactly once.
+    hi = lo + sizeof(kMagic) - 1;
+  }
+  return 0;
+}
+
+// Parses the segment ending at end into groups and returns where the previous
+// segment ends (0 when this is the first).
+template <typename IndexT>
+std::uint64_t RowGroupFile<IndexT>::read_segment(std::uint64_t end, std::vector<Group>& groups) {
+  std::string footer;
+  if (!read_footer(end, footer)) {
+    throw std::runtime_error("row_group_file: invalid file footer");
+  }
+  const std::uint64_t footer_length = footer.size();
+  const std::uint64_t footer_start = end - 2 * sizeof(std::uint64_t) - sizeof(kMagic) - footer_length;
+  // The footer is parsed from memory so every count and string length can be
+  // checked against the bytes that remain before anything is allocated.
+  std::istringstream input(footer);
+  auto remaining = [&]() { return footer_length - static_cast<std::uint64_t>(input.tellg()); };
+
+  const auto previous_end = detail::read_pod<std::uint64_t>(input);
+  const std::uint64_t data_begin = previous_end == 0 ? sizeof(kMagic) : previous_end;
+  if (data_begin > footer_start) {
+    throw std::runtime_error("row_group_file: corrupt segment chain");
+  }
+  const std::string index_name = detail::read_string(input, remaining());
+  const auto column_count = detail::read_pod<std::uint64_t>(input);
+  if (column_count > remaining() / sizeof(std::uint64_t)) {
+    throw std::runtime_error("row_group_file: corrupt column count");
+  }
+  std::vector<std::string> columns(static_cast<std::size_t>(column_count));
+  for (auto& name : columns) {
+    name = detail::read_string(input, remaining());
+  }
+  if (segment_count_ == 0) {
+    index_name_ = index_name;
+    columns_ = columns;
+  } else if (columns != columns_) {
+    throw std::runtime_error("row_group_file: segments disagree on columns");
+  }
+  const auto group_count = detail::read_pod<std::uint64_t>(input);
+  if (group_count > remaining() / (3 * sizeof(std::uint64_t))) {
+    throw std::runtime_error("row_group_file: corrupt group count");
+  }
+  groups.resize(static_cast<std::size_t>(group_count));
+  for (auto& group : groups) {
+    group.offset = detail::read_pod<std::uint64_t>(input);
+    group.length = detail::read_pod<std::uint64_t>(input);
+    group.rows = static_cast<std::size_t>(detail::read_pod<std::uint64_t>(input));
+    if (group.offset < data_begin || group.length > footer_start ||
+        group.offset > footer_start - group.length) {
+      throw std::runtime_error("row_group_file: group lies outside its segment");
+    }
+    group.index_min = detail::read_index_value<IndexT>(input, remaining());
+    group.index_max = detail::read_index_value<IndexT>(input, remaining());
+    group.columns.resize(columns_.size());
+    for (auto& stats : group.columns) {
+      stats.min = detail::read_pod<double>(input);
+      stats.max = detail::read_pod<double>(input);
+      stats.nan_count = static_cast<std::size_t>(detail::read_pod<std::uint64_t>(input));
+    }
+  }
+  ++segment_count_;
+  return previous_end;
+}
+
+template <typename IndexT>
+std::size_t RowGroupFile<IndexT>::rows() const {
+  std::size_t total = 0;
+  for (const auto& group : groups_) total += group.rows;
+  return total;
+}
+
+template <typename IndexT>
+std::vector<std::size_t> RowGroupFile<IndexT>::groups_in_range(IndexT start,
+                                                               IndexT end,
+                                                               bool inclusive_end) const {
+  IndexT lo = start;
+  IndexT hi = end;
+  if (hi < lo) std::swap(lo, hi);
+  std::vector<std::size_t> out;
+  for (std::size_t g = 0; g < groups_.size(); ++g) {
+    const Group& group = groups_[g];
+    const bool below = group.index_max < lo;
+    const bool above = inclusive_end ? group.index_min > hi : group.index_min >= hi;
+    if (!below && !above) out.push_back(g);
+  }
+  return out;
+}
+
+template <typename IndexT>
+std::vector<std::size_t> RowGroupFile<IndexT>::groups_between(const std::string& column,
+                                                              double lower,
+                                                              double upper) const {
+  const std::size_t c = column_position(column);
+  std::vector<std::size_t> out;
+  for (std::size_t g = 0; g < groups_.size(); ++g) {
+    const ColumnStats& stats = groups_[g].columns[c];
+    if (std::isnan(stats.min) || stats.max < lower || stats.min > upper) continue;
+    out.push_back(g);
+  }
+  return out;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> RowGroupFile<IndexT>::read_group(std::size_t g) const {
+  return read_groups({g});
+}
+
+template <typename IndexT>
+DataFrame<IndexT> RowGroupFile<IndexT>::read_groups(const std::vector<std::size_t>& groups) const {
+  DataFrame<IndexT> out = empty_frame();
+  if (groups.empty()) return out;
+  std::size_t total = 0;
+  for (std::size_t g : groups) total += group(g).rows;
+  out.reserve_rows(total);
+  for (std::size_t g : groups) {
+    const Group& info = group(g);
+    std::string bytes(static_cast<std::size_t>(info.length), '\0');
+    {
+      std::lock_guard<std::mutex> lock(file_mutex_);
+      file_.clear();
+      file_.seekg(static_cast<std::streamoff>(info.offset));
+      file_.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+      if (!file_) {
+        throw std::runtime_error("row_group_file: failed to read group");
+      }
+    }
+    std::istringstream input(bytes);
+    DataFrame<IndexT> chunk = DataFrame<IndexT>::from_binary(input);
+    if (chunk.rows() != info.rows || chunk.columns() != columns_) {
+      throw std::runtime_error("row_group_file: group does not match the footer");
+    }
+    out.append_rows(chunk);
+  }
+  return out;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> RowGroupFile<IndexT>::read_all() const {
+  std::vector<std::size_t> all(groups_.size());
+  for (std::size_t g = 0; g < all.size(); ++g) all[g] = g;
+  return read_groups(all);
+}
+
+template <typename IndexT>
+DataFrame<IndexT> RowGroupFile<IndexT>::tail_rows(std::size_t count) const {
+  std::vector<std::size_t> needed;
+  std::size_t covered = 0;
+  for (std::size_t g = groups_.size(); g-- > 0 && covered < count;) {
+    needed.push_back(g);
+    covered += groups_[g].rows;
+  }
+  std::reverse(needed.begin(), needed.end());
+  return read_groups(needed).tail_rows(count);
+}
+
+template <typename IndexT>
+DataFrame<IndexT> RowGroupFile<IndexT>::slice_rows_range(IndexT start,
+                                                         IndexT end,
+                                                         bool inclusive_end) const {
+  return read_groups(groups_in_range(start, end, inclusive_end))
+      .slice_rows_range(start, end, inclusive_end);
+}
+
+template <typename IndexT>
+DataFrame<IndexT> RowGroupFile<IndexT>::filter_between(const std::string& column,
+                                                       double lower,
+                                                       double upper) const {
+  const std::size_t c = column_position(column);
+  const DataFrame<IndexT> candidates = read_groups(groups_between(column, lower, upper));
+  DataFrame<IndexT> out = empty_frame();
+  std::vector<double> row(columns_.size());
+  for (std::size_t r = 0; r < candidates.rows(); ++r) {
+    const double value = candidates.value(r, c);
+    if (!(value >= lower && value <= upper)) continue;
+    for (std::size_t j = 0; j < row.size(); ++j) row[j] = candidates.value(r, j);
+    out.append_row(candidates.index()[r], row.data(), row.size());
+  }
+  return out;
+}
+
+template <typename IndexT>
+DataFrame<IndexT> RowGroupFile<IndexT>::empty_frame() const {
+  DataFrame<IndexT> out = DataFrame<IndexT>::from_vectors({}, columns_, {});
+  out.set_index_name(index_name_);
+  return out;
+}
+
+template <typename IndexT>
+std::size_t RowGroupFile<IndexT>::column_position(const std::string& column) const {
+  for (std::size_t c = 0; c < columns_.size(); ++c) {
+    if (columns_[c] == column) return c;
+  }
+  throw std::runtime_error("row_group_file: column not found");
+}
+
+}  // namespace df
+
+#endif
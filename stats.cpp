@@ -2,8 +2,11 @@
 // doc: implementations for stats.h
 
 #include "stats.h"
+#include "parallel.h"
 
+#include <algorithm>
 #include <cmath>
+#include <complex>
 #include <iomanip>
 #include <limits>
 #include <ostream>
@@ -11,6 +14,125 @@
 
 namespace stats {
 
+namespace {
+
+// doc: lag count above which autocorrelations switches from the direct loop to the FFT.
+const int kFftMinLag = 32;
+
+// doc: in-place iterative radix-2 FFT; a.size() must be a power of two. inverse also scales by 1/n.
+void fft_radix2(std::vector<std::complex<double> >& a, bool inverse) {
+	const size_t n = a.size();
+	if (n <= 1) return;
+
+	for (size_t i = 1, j = 0; i < n; ++i) {
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1) j ^= bit;
+		j ^= bit;
+		if (i < j) std::swap(a[i], a[j]);
+	}
+
+	// doc: twiddles are taken from one table of exact roots to avoid drift from repeated multiplication.
+	const double pi = 3.14159265358979323846;
+	const double sign = inverse ? 1.0 : -1.0;
+	std::vector<std::complex<double> > roots(n / 2);
+	for (size_t k = 0; k < n / 2; ++k) {
+		const double ang = sign * 2.0 * pi * (double)k / (double)n;
+		roots[k] = std::complex<double>(std::cos(ang), std::sin(ang));
+	}
+
+	for (size_t len = 2; len <= n; len <<= 1) {
+		const size_t half = len / 2;
+		const size_t step = n / len;
+		for (size_t i = 0; i < n; i += len) {
+			for (size_t j = 0; j < half; ++j) {
+				const std::complex<double> u = a[i + j];
+				const std::complex<double> v = a[i + j + half] * roots[j * step];
+				a[i + j] = u + v;
+				a[i + j + half] = u - v;
+			}
+		}
+	}
+
+	if (inverse) {
+		const double scale = 1.0 / (double)n;
+		for (size_t i = 0; i < n; ++i) a[i] *= scale;
+	}
+}
+
+// doc: demeaned finite returns (NaN kept as NaN) plus their sample mean and variance.
+struct CenteredReturns {
+	std::vector<double> e;
+	double mu;
+	double var;
+	long long n;
+};
+
+CenteredReturns center_returns(const std::vector<double>& returns) {
+	CenteredReturns c;
+	c.e.assign(returns.size(), std::numeric_limits<double>::quiet_NaN());
+	c.n = 0;
+	double sum = 0.0;
+	for (double v : returns) {
+		if (std::isfinite(v)) {
+			sum += v;
+			++c.n;
+		}
+	}
+	c.mu = (c.n > 0) ? sum / (double)c.n : std::numeric_limits<double>::quiet_NaN();
+	double ss = 0.0;
+	for (size_t i = 0; i < returns.size(); ++i) {
+		if (!std::isfinite(returns[i])) continue;
+		c.e[i] = returns[i] - c.mu;
+		ss += c.e[i] * c.e[i];
+	}
+	c.var = (c.n > 0) ? ss / (double)c.n : std::numeric_limits<double>::quiet_NaN();
+	return c;
+}
+
+// doc: batched negative Gaussian log-likelihood (without constants) for K (alpha, beta) candidates in one data pass.
+// doc: omega is variance-targeted as var*(1-alpha-beta); infeasible candidates get +inf.
+void garch11_batch_nll(const CenteredReturns& c,
+		       const std::vector<double>& alpha,
+		       const std::vector<double>& beta,
+		       std::vector<double>& nll) {
+	const size_t k = alpha.size();
+	const double inf = std::numeric_limits<double>::infinity();
+	std::vector<double> omega(k), h(k, c.var), prev_sq(k, c.var);
+	nll.assign(k, 0.0);
+	for (size_t j = 0; j < k; ++j) {
+		omega[j] = c.var * (1.0 - alpha[j] - beta[j]);
+		if (!(alpha[j] >= 0.0) || !(beta[j] >= 0.0) || !(alpha[j] + beta[j] < 1.0)) nll[j] = inf;
+	}
+	bool first = true;
+	for (size_t t = 0; t < c.e.size(); ++t) {
+		const double e = c.e[t];
+		if (!(e == e)) continue;
+		const double e2 = e * e;
+		if (!first) {
+			for (size_t j = 0; j < k; ++j) h[j] = omega[j] + alpha[j] * prev_sq[j] + beta[j] * h[j];
+		}
+		first = false;
+		for (size_t j = 0; j < k; ++j) {
+			nll[j] += std::log(h[j]) + e2 / h[j];
+			prev_sq[j] = e2;
+		}
+	}
+	for (size_t j = 0; j < k; ++j) {
+		if (!(nll[j] == nll[j])) nll[j] = inf;
+	}
+}
+
+// doc: minimum multiply-adds per thread for the eigen-solver's parallel loops. Each loop is entered O(n) times per
+// doc: decomposition and parallel_for starts fresh threads every time, so a chunk must outweigh a thread start.
+const size_t kEigenMinWork = size_t(1) << 18;
+
+// doc: parallel_for chunk size that gives each thread at least kEigenMinWork when every item costs work_per_item.
+size_t eigen_chunk(size_t work_per_item) {
+	return kEigenMinWork / std::max<size_t>(work_per_item, 1) + 1;
+}
+
+}  // namespace
+
 double mean(const std::vector<double>& x) {
   // doc: arithmetic mean.
 	const long long n = (long long)x.size();
@@ -82,6 +204,7 @@ std::vector<double> autocorrelations(const std::vector<double>& x, int k) {
 
 	if (k <= 0 || n <= 1) return r;
 	if (k > (int)(n - 1)) k = (int)(n - 1);
+	if (k > kFftMinLag) return autocorrelations_fft(x, k);
 
 	r.assign((size_t)k, std::numeric_limits<double>::quiet_NaN());
 
@@ -107,6 +230,43 @@ std::vector<double> autocorrelations(const std::vector<double>& x, int k) {
 	return r;
 }
 
+std::vector<double> autocorrelations_fft(const std::vector<double>& x, int k) {
+  // doc: Wiener-Khinchin ACF: zero-pad the centered series to >= n+k, inverse-transform |X|^2.
+	const long long n = (long long)x.size();
+	std::vector<double> r;
+
+	if (k <= 0 || n <= 1) return r;
+	if (k > (int)(n - 1)) k = (int)(n - 1);
+
+	r.assign((size_t)k, std::numeric_limits<double>::quiet_NaN());
+
+	const double m = mean(x);
+
+	size_t padded = 1;
+	while (padded < (size_t)n + (size_t)k) padded <<= 1;
+
+	std::vector<std::complex<double> > buf(padded, std::complex<double>(0.0, 0.0));
+	double denom = 0.0;
+	for (long long t = 0; t < n; ++t) {
+		const double d = x[(size_t)t] - m;
+		buf[(size_t)t] = std::complex<double>(d, 0.0);
+		denom += d * d;
+	}
+	if (!(denom > 0.0)) return r;
+
+	fft_radix2(buf, false);
+	for (size_t i = 0; i < padded; ++i) {
+		buf[i] = std::complex<double>(std::norm(buf[i]), 0.0);
+	}
+	fft_radix2(buf, true);
+
+	for (int lag = 1; lag <= k; ++lag) {
+		r[(size_t)(lag - 1)] = buf[(size_t)lag].real() / denom;
+	}
+
+	return r;
+}
+
 std::vector<double> simulate_ar1(long long n,
 				 double phi,
 				 double sigma_eps,
@@ -232,7 +392,150 @@ void print_summary(const std::vector<double>& x,
 }
 
 
-// doc: return elementwise returns[i]/cond_sd[i]; uses fill_value when cond_sd[i] is nonpositive or non-finite.
+Garch11Fit fit_garch11(const std::vector<double>& returns) {
+  // doc: coarse (alpha, beta) grid scored in one batched pass, then Nelder-Mead refinement from the best point.
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	const CenteredReturns c = center_returns(returns);
+	Garch11Fit fit;
+	fit.mu = c.mu;
+	fit.n = c.n;
+	fit.omega = nan;
+	fit.alpha = nan;
+	fit.beta = nan;
+	fit.log_likelihood = nan;
+	if (c.n < 10 || !(c.var > 0.0)) return fit;
+
+	std::vector<double> grid_a, grid_b, nll;
+	for (double a = 0.01; a < 0.31; a += 0.03) {
+		for (double b = 0.50; b < 0.99; b += 0.04) {
+			if (a + b < 0.999) {
+				grid_a.push_back(a);
+				grid_b.push_back(b);
+			}
+		}
+	}
+	garch11_batch_nll(c, grid_a, grid_b, nll);
+	const size_t best = (size_t)(std::min_element(nll.begin(), nll.end()) - nll.begin());
+
+	// doc: the 3-point simplex is scored with the same batched kernel on every step.
+	double pa[3] = {grid_a[best], grid_a[best] + 0.02, grid_a[best]};
+	double pb[3] = {grid_b[best], grid_b[best], grid_b[best] - 0.04};
+	double fv[3];
+	{
+		std::vector<double> a(pa, pa + 3), b(pb, pb + 3);
+		garch11_batch_nll(c, a, b, nll);
+		for (int i = 0; i < 3; ++i) fv[i] = nll[(size_t)i];
+	}
+	auto eval1 = [&](double a, double b) {
+		std::vector<double> va(1, a), vb(1, b);
+		garch11_batch_nll(c, va, vb, nll);
+		return nll[0];
+	};
+
+	for (int iter = 0; iter < 200; ++iter) {
+		int order[3] = {0, 1, 2};
+		std::sort(order, order + 3, [&](int i, int j) { return fv[i] < fv[j]; });
+		const int lo = order[0], mid = order[1], hi = order[2];
+		if (std::fabs(fv[hi] - fv[lo]) < 1e-10 * (1.0 + std::fabs(fv[lo]))) break;
+		const double ca = 0.5 * (pa[lo] + pa[mid]);
+		const double cb = 0.5 * (pb[lo] + pb[mid]);
+		const double ra = 2.0 * ca - pa[hi], rb = 2.0 * cb - pb[hi];
+		const double fr = eval1(ra, rb);
+		if (fr < fv[lo]) {
+			const double ea = 3.0 * ca - 2.0 * pa[hi], eb = 3.0 * cb - 2.0 * pb[hi];
+			const double fe = eval1(ea, eb);
+			if (fe < fr) {
+				pa[hi] = ea; pb[hi] = eb; fv[hi] = fe;
+			} else {
+				pa[hi] = ra; pb[hi] = rb; fv[hi] = fr;
+			}
+		} else if (fr < fv[mid]) {
+			pa[hi] = ra; pb[hi] = rb; fv[hi] = fr;
+		} else {
+			const double ka = 0.5 * (ca + pa[hi]), kb = 0.5 * (cb + pb[hi]);
+			const double fk = eval1(ka, kb);
+			if (fk < fv[hi]) {
+				pa[hi] = ka; pb[hi] = kb; fv[hi] = fk;
+			} else {
+				for (int i = 0; i < 3; ++i) {
+					if (i == lo) continue;
+					pa[i] = 0.5 * (pa[i] + pa[lo]);
+					pb[i] = 0.5 * (pb[i] + pb[lo]);
+					fv[i] = eval1(pa[i], pb[i]);
+				}
+			}
+		}
+	}
+
+	const int lo = (int)(std::min_element(fv, fv + 3) - fv);
+	const double pi = 3.14159265358979323846;
+	fit.alpha = pa[lo];
+	fit.beta = pb[lo];
+	fit.omega = c.var * (1.0 - fit.alpha - fit.beta);
+	fit.log_likelihood = -0.5 * (fv[lo] + (double)c.n * std::log(2.0 * pi));
+	return fit;
+}
+
+std::vector<double> garch11_conditional_sd(const std::vector<double>& returns, const Garch11Fit& fit) {
+  // doc: filter h_t through the sample; NaN returns leave the state unchanged and carry the last sd forward.
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	std::vector<double> out(returns.size(), nan);
+	if (!(fit.omega > 0.0) || !(fit.alpha >= 0.0) || !(fit.beta >= 0.0)) return out;
+	const CenteredReturns c = center_returns(returns);
+	if (!(c.var > 0.0)) return out;
+
+	double h = c.var;
+	double prev_sq = c.var;
+	bool started = false;
+	for (size_t t = 0; t < returns.size(); ++t) {
+		const double e = std::isfinite(returns[t]) ? returns[t] - fit.mu : nan;
+		if (!started) {
+			if (!(e == e)) continue;
+			started = true;
+		} else if (e == e) {
+			h = fit.omega + fit.alpha * prev_sq + fit.beta * h;
+		}
+		out[t] = std::sqrt(h);
+		if (e == e) prev_sq = e * e;
+	}
+	return out;
+}
+
+std::vector<double> ewma_conditional_sd(const std::vector<double>& returns, double lambda) {
+  // doc: zero-mean RiskMetrics recursion; NaN returns leave the state unchanged and carry the last sd forward.
+	if (!(lambda > 0.0) || !(lambda < 1.0)) {
+		throw std::runtime_error("ewma_conditional_sd: lambda must be in (0,1)");
+	}
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	std::vector<double> out(returns.size(), nan);
+	double sum_sq = 0.0;
+	long long n = 0;
+	for (double v : returns) {
+		if (std::isfinite(v)) {
+			sum_sq += v * v;
+			++n;
+		}
+	}
+	if (n == 0) return out;
+
+	double h = sum_sq / (double)n;
+	double prev_sq = h;
+	bool started = false;
+	for (size_t t = 0; t < returns.size(); ++t) {
+		const bool valid = std::isfinite(returns[t]);
+		if (!started) {
+			if (!valid) continue;
+			started = true;
+		} else if (valid) {
+			h = lambda * h + (1.0 - lambda) * prev_sq;
+		}
+		out[t] = std::sqrt(h);
+		if (valid) prev_sq = returns[t] * returns[t];
+	}
+	return out;
+}
+
+// doc: return elementwise returns[i]/cond_sd[i]; uses fill_value (NaN by default) when cond_sd[i] is nonpositive or non-finite.
 std::vector<double> standardize_returns(const std::vector<double>& returns,
                                         const std::vector<double>& cond_sd,
                                         double fill_value) {
@@ -313,5 +616,246 @@ void print_autocorr_table(const std::vector<double>& x,
     os.flags(old_flags);
 }
 
+bool cholesky_decompose(std::vector<double>& a, size_t n) {
+	if (a.size() != n * n) throw std::runtime_error("cholesky_decompose: matrix size mismatch");
+	for (size_t j = 0; j < n; ++j) {
+		double* row_j = &a[j * n];
+		double diag = row_j[j];
+		for (size_t k = 0; k < j; ++k) diag -= row_j[k] * row_j[k];
+		if (!(diag > 0.0)) return false;
+		const double ljj = std::sqrt(diag);
+		row_j[j] = ljj;
+		for (size_t i = j + 1; i < n; ++i) {
+			double* row_i = &a[i * n];
+			double v = row_i[j];
+			for (size_t k = 0; k < j; ++k) v -= row_i[k] * row_j[k];
+			row_i[j] = v / ljj;
+		}
+		for (size_t k = j + 1; k < n; ++k) row_j[k] = 0.0;
+	}
+	return true;
+}
+
+void cholesky_solve(const std::vector<double>& l, size_t n, std::vector<double>& b) {
+	if (l.size() != n * n || b.size() != n) throw std::runtime_error("cholesky_solve: size mismatch");
+	for (size_t i = 0; i < n; ++i) {
+		double v = b[i];
+		for (size_t k = 0; k < i; ++k) v -= l[i * n + k] * b[k];
+		b[i] = v / l[i * n + i];
+	}
+	for (size_t i = n; i-- > 0;) {
+		double v = b[i];
+		for (size_t k = i + 1; k < n; ++k) v -= l[k * n + i] * b[k];
+		b[i] = v / l[i * n + i];
+	}
+}
+
+std::vector<double> cholesky_inverse_diagonal(const std::vector<double>& l, size_t n) {
+	if (l.size() != n * n) throw std::runtime_error("cholesky_inverse_diagonal: matrix size mismatch");
+	// doc: (L L^T)^{-1} = L^{-T} L^{-1}, so entry jj is the squared norm of column j of L^{-1}.
+	std::vector<double> out(n, 0.0);
+	std::vector<double> col(n);
+	for (size_t j = 0; j < n; ++j) {
+		std::fill(col.begin(), col.end(), 0.0);
+		col[j] = 1.0 / l[j * n + j];
+		out[j] += col[j] * col[j];
+		for (size_t i = j + 1; i < n; ++i) {
+			double v = 0.0;
+			for (size_t k = j; k < i; ++k) v -= l[i * n + k] * col[k];
+			col[i] = v / l[i * n + i];
+			out[j] += col[i] * col[i];
+		}
+	}
+	return out;
+}
+
+// doc: Householder tridiagonalization followed by implicit QL (the EISPACK tred2/tql2 pair).
+// doc: the working matrix is column-major so every inner loop runs down a contiguous column; the Givens rotations
+// doc: of each QL iteration are recorded and then applied to row blocks of the eigenvector matrix in parallel.
+// doc: loops only go parallel once a thread's share of the step reaches kEigenMinWork, so small and mid-sized
+// doc: matrices, and the short rotation batches near convergence, run on the calling thread.
+SymmetricEigen symmetric_eigen(const std::vector<double>& a, size_t n) {
+	if (a.size() != n * n) throw std::runtime_error("symmetric_eigen: matrix size mismatch");
+	SymmetricEigen out;
+	out.n = n;
+	if (n == 0) return out;
+
+	std::vector<double> v(a);
+	for (size_t i = 0; i < n; ++i) {
+		for (size_t j = 0; j < i; ++j) v[j * n + i] = v[i * n + j];  // use the lower triangle
+	}
+	auto V = [&v, n](size_t row, size_t col) -> double& { return v[col * n + row]; };
+	std::vector<double> d(n), e(n, 0.0);
+
+	for (size_t j = 0; j < n; ++j) d[j] = V(n - 1, j);
+	for (size_t i = n - 1; i > 0; --i) {
+		double scale = 0.0;
+		double h = 0.0;
+		for (size_t k = 0; k < i; ++k) scale += std::fabs(d[k]);
+		if (scale == 0.0) {
+			e[i] = d[i - 1];
+			for (size_t j = 0; j < i; ++j) {
+				d[j] = V(i - 1, j);
+				V(i, j) = 0.0;
+				V(j, i) = 0.0;
+			}
+		} else {
+			for (size_t k = 0; k < i; ++k) {
+				d[k] /= scale;
+				h += d[k] * d[k];
+			}
+			double f = d[i - 1];
+			double g = std::sqrt(h);
+			if (f > 0) g = -g;
+			e[i] = scale * g;
+			h -= f * g;
+			d[i - 1] = f - g;
+			for (size_t j = 0; j < i; ++j) e[j] = 0.0;
+			for (size_t j = 0; j < i; ++j) {
+				f = d[j];
+				V(j, i) = f;
+				g = e[j] + V(j, j) * f;
+				double* col = &V(0, j);
+				for (size_t k = j + 1; k < i; ++k) {
+					g += col[k] * d[k];
+					e[k] += col[k] * f;
+				}
+				e[j] = g;
+			}
+			f = 0.0;
+			for (size_t j = 0; j < i; ++j) {
+				e[j] /= h;
+				f += e[j] * d[j];
+			}
+			const double hh = f / (h + h);
+			for (size_t j = 0; j < i; ++j) e[j] -= hh * d[j];
+			df::detail::parallel_for(i, [&](size_t begin, size_t end) {
+				for (size_t j = begin; j < end; ++j) {
+					const double fj = d[j];
+					const double gj = e[j];
+					double* col = &V(0, j);
+					for (size_t k = j; k < i; ++k) col[k] -= (fj * e[k] + gj * d[k]);
+				}
+			}, eigen_chunk(i));
+			for (size_t j = 0; j < i; ++j) {
+				d[j] = V(i - 1, j);
+				V(i, j) = 0.0;
+			}
+		}
+		d[i] = h;
+	}
+
+	// doc: accumulate the Householder transformations into V.
+	for (size_t i = 0; i + 1 < n; ++i) {
+		V(n - 1, i) = V(i, i);
+		V(i, i) = 1.0;
+		const double h = d[i + 1];
+		if (h != 0.0) {
+			const double* next = &V(0, i + 1);
+			for (size_t k = 0; k <= i; ++k) d[k] = next[k] / h;
+			df::detail::parallel_for(i + 1, [&](size_t begin, size_t end) {
+				for (size_t j = begin; j < end; ++j) {
+					double* col = &V(0, j);
+					double g = 0.0;
+					for (size_t k = 0; k <= i; ++k) g += next[k] * col[k];
+					for (size_t k = 0; k <= i; ++k) col[k] -= g * d[k];
+				}
+			}, eigen_chunk(2 * (i + 1)));
+		}
+		for (size_t k = 0; k <= i; ++k) V(k, i + 1) = 0.0;
+	}
+	for (size_t j = 0; j < n; ++j) {
+		d[j] = V(n - 1, j);
+		V(n - 1, j) = 0.0;
+	}
+	V(n - 1, n - 1) = 1.0;
+	e[0] = 0.0;
+
+	// doc: implicit QL on the tridiagonal (d, e).
+	for (size_t i = 1; i < n; ++i) e[i - 1] = e[i];
+	e[n - 1] = 0.0;
+	double f = 0.0;
+	double tst1 = 0.0;
+	const double eps = std::numeric_limits<double>::epsilon();
+	std::vector<double> rot_c(n), rot_s(n);
+	for (size_t l = 0; l < n; ++l) {
+		tst1 = std::max(tst1, std::fabs(d[l]) + std::fabs(e[l]));
+		size_t m = l;
+		while (m < n - 1 && std::fabs(e[m]) > eps * tst1) ++m;
+		if (m > l) {
+			int iter = 0;
+			do {
+				if (++iter > 100) throw std::runtime_error("symmetric_eigen: QL iteration did not converge");
+				double g = d[l];
+				double p = (d[l + 1] - g) / (2.0 * e[l]);
+				double r = std::hypot(p, 1.0);
+				if (p < 0) r = -r;
+				d[l] = e[l] / (p + r);
+				d[l + 1] = e[l] * (p + r);
+				const double dl1 = d[l + 1];
+				double h = g - d[l];
+				for (size_t i = l + 2; i < n; ++i) d[i] -= h;
+				f += h;
+
+				p = d[m];
+				double c = 1.0, c2 = c, c3 = c;
+				const double el1 = e[l + 1];
+				double sn = 0.0, s2 = 0.0;
+				for (size_t i = m; i-- > l;) {
+					c3 = c2;
+					c2 = c;
+					s2 = sn;
+					g = c * e[i];
+					h = c * p;
+					r = std::hypot(p, e[i]);
+					e[i + 1] = sn * r;
+					sn = e[i] / r;
+					c = p / r;
+					p = c * d[i] - sn * g;
+					d[i + 1] = h + sn * (c * g + sn * d[i]);
+					rot_c[i] = c;
+					rot_s[i] = sn;
+				}
+				df::detail::parallel_for(n, [&](size_t begin, size_t end) {
+					for (size_t i = m; i-- > l;) {
+						double* left = &V(0, i);
+						double* right = &V(0, i + 1);
+						const double ci = rot_c[i];
+						const double si = rot_s[i];
+						for (size_t k = begin; k < end; ++k) {
+							const double hk = right[k];
+							right[k] = si * left[k] + ci * hk;
+							left[k] = ci * left[k] - si * hk;
+						}
+					}
+				}, eigen_chunk(2 * (m - l)));
+				p = -sn * s2 * c3 * el1 * e[l] / dl1;
+				e[l] = sn * p;
+				d[l] = c * p;
+			} while (std::fabs(e[l]) > eps * tst1);
+		}
+		d[l] += f;
+		e[l] = 0.0;
+	}
+
+	// doc: order by descending eigenvalue and fix each vector's sign so its largest-magnitude entry is positive.
+	std::vector<size_t> order(n);
+	for (size_t i = 0; i < n; ++i) order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&d](size_t x, size_t y) { return d[x] > d[y]; });
+	out.values.resize(n);
+	out.vectors.resize(n * n);
+	for (size_t j = 0; j < n; ++j) {
+		const double* src = &v[order[j] * n];
+		size_t pivot = 0;
+		for (size_t k = 1; k < n; ++k) {
+			if (std::fabs(src[k]) > std::fabs(src[pivot])) pivot = k;
+		}
+		const double sign = src[pivot] < 0.0 ? -1.0 : 1.0;
+		out.values[j] = d[order[j]];
+		for (size_t k = 0; k < n; ++k) out.vectors[j * n + k] = sign * src[k];
+	}
+	return out;
+}
+
 }  // namespace stats
 
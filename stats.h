@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <limits>
 #include <random>
 #include <vector>
 
@@ -34,8 +35,12 @@ double skew(const std::vector<double>& x);
 double excess_kurtosis(const std::vector<double>& x);
 
 // doc: return sample autocorrelations for lags 1..k (mean-centered); empty if k<=0; NaN values if undefined.
+// doc: large k is routed to autocorrelations_fft, small k uses the direct O(n*k) lag loop.
 std::vector<double> autocorrelations(const std::vector<double>& x, int k);
 
+// doc: same result as autocorrelations, computed for all lags at once via a zero-padded FFT in O(n log n).
+std::vector<double> autocorrelations_fft(const std::vector<double>& x, int k);
+
 // doc: simulate n observations from AR(1): x_t = mu + phi*(x_{t-1}-mu) + sigma_eps*e_t, using provided RNG.
 std::vector<double> simulate_ar1(long long n,
 				 double phi,
@@ -70,10 +75,50 @@ void print_autocorr_table(const std::vector<double>& x,
                           int precision = 3,
                           bool print_header = true);
 
-// doc: return elementwise returns[i]/cond_sd[i]; uses fill_value when cond_sd[i] is nonpositive or non-finite.
+// doc: GARCH(1,1) parameters: r_t = mu + e_t, h_t = omega + alpha*e_{t-1}^2 + beta*h_{t-1}.
+struct Garch11Fit {
+	double mu;
+	double omega;
+	double alpha;
+	double beta;
+	double log_likelihood;
+	long long n;
+};
+
+// doc: fit GARCH(1,1) by Gaussian quasi-MLE with variance targeting; NaN values are skipped. NaN fields if n<10.
+Garch11Fit fit_garch11(const std::vector<double>& returns);
+
+// doc: one-step-ahead conditional sd sqrt(h_t) aligned with returns; NaN before the first finite return.
+std::vector<double> garch11_conditional_sd(const std::vector<double>& returns, const Garch11Fit& fit);
+
+// doc: RiskMetrics EWMA conditional sd, h_t = lambda*h_{t-1} + (1-lambda)*r_{t-1}^2, seeded with the mean of r^2.
+std::vector<double> ewma_conditional_sd(const std::vector<double>& returns, double lambda = 0.94);
+
+// doc: return elementwise returns[i]/cond_sd[i]; uses fill_value (NaN by default) when cond_sd[i] is nonpositive or non-finite.
 std::vector<double> standardize_returns(const std::vector<double>& returns,
 					const std::vector<double>& cond_sd,
-					double fill_value = 0.0);
+					double fill_value = std::numeric_limits<double>::quiet_NaN());
+
+// doc: factor the n x n row-major symmetric matrix a in place into its lower Cholesky factor L (upper part zeroed).
+// doc: returns false, leaving a partially overwritten, if a is not numerically positive definite.
+bool cholesky_decompose(std::vector<double>& a, size_t n);
+
+// doc: solve (L L^T) x = b in place, where l is the factor produced by cholesky_decompose.
+void cholesky_solve(const std::vector<double>& l, size_t n, std::vector<double>& b);
+
+// doc: diagonal of (L L^T)^{-1} from the Cholesky factor l; used for regression standard errors.
+std::vector<double> cholesky_inverse_diagonal(const std::vector<double>& l, size_t n);
+
+// doc: eigenvalues in descending order; vectors holds eigenvector j contiguously at [j*n, (j+1)*n).
+struct SymmetricEigen {
+	std::vector<double> values;
+	std::vector<double> vectors;
+	size_t n = 0;
+};
+
+// doc: eigen-decomposition of the n x n row-major symmetric matrix a (the lower triangle is used).
+// doc: Householder tridiagonalization + implicit QL in O(n^3), threaded over matrix columns/rows for large n.
+SymmetricEigen symmetric_eigen(const std::vector<double>& a, size_t n);
 
 }  // namespace stats
 
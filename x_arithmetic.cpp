@@ -23,6 +23,15 @@ int main() {
     auto exp_back = logs.exp_elements();
     df::print::print_frame(logs, "log subset", false);
     df::print::print_frame(exp_back, "exp(log subset)", false);
+
+    auto window = prices.select_columns({"SPY", "EFA"}).head_rows(8);
+    df::print::print_frame(window.shift(2), "shift(2)", false);
+    df::print::print_frame(window.diff(-1), "diff(-1)", false);
+    df::print::print_frame(window.pct_change(3), "pct_change(3)", false);
+    df::print::print_frame(window.log_change(1), "log_change(1)", false);
+
+    auto features = window.multi_lag_changes({1, 2, 5}, df::ChangeKind::log);
+    df::print::print_frame(features, "log changes at lags 1, 2, 5", false);
   } catch (const std::exception& ex) {
     std::cerr << "x_arithmetic error: " << ex.what() << "\n";
     return 1;
@@ -2,6 +2,8 @@
 #include "sample_utils.h"
 
 #include <iostream>
+#include <limits>
+#include <vector>
 
 int main() {
   try {
@@ -15,6 +17,25 @@ int main() {
     std::cout << "\n\nfirst rows\n";
     df::print::print_frame(prices.head_rows(3), "prices head", false);
     df::print::print_frame(prices.tail_rows(3), "prices tail", false);
+
+    // Punch holes into a few rows of SPY/TLT (skipping a weekend) and repair them.
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    auto window = prices.select_columns({"SPY", "TLT"}).head_rows(8);
+    std::vector<std::vector<double>> gappy = {
+        {100.0, 50.0}, {nan, 51.0}, {nan, nan}, {103.0, nan},
+        {nan, nan}, {nan, 55.0}, {106.0, nan}, {nan, nan}};
+    auto holes = df::DataFrame<df::Date>::from_vectors(window.index(), window.columns(), gappy);
+    holes.set_index_name("Date");
+    df::print::print_frame(holes, "with gaps", false);
+    auto forward = holes;
+    forward.ffill(1);
+    df::print::print_frame(forward, "ffill(limit=1)", false);
+    auto backward = holes;
+    backward.bfill();
+    df::print::print_frame(backward, "bfill()", false);
+    auto interpolated = holes;
+    interpolated.interpolate();
+    df::print::print_frame(interpolated, "time-weighted interpolate()", false);
   } catch (const std::exception& ex) {
     std::cerr << "x_basic error: " << ex.what() << "\n";
     return 1;
@@ -18,6 +18,21 @@ int main() {
     std::vector<double> gamma = {10.0, 20.0, 30.0};
     frame.add_column("Gamma", gamma);
     df::print::print_frame(frame, "after add_column", false);
+
+    frame.reserve_rows(8);
+    frame.append_row(df::Date(2024, 1, 4), {7.0, 8.0, 40.0});
+    auto batch = df::DataFrame<df::Date>::from_vectors(
+        {df::Date(2024, 1, 5), df::Date(2024, 1, 8)},
+        frame.columns(),
+        {{9.0, 10.0, 50.0}, {11.0, 12.0, 60.0}});
+    frame.append_rows(batch);
+    df::print::print_frame(frame, "after append_row/append_rows", false);
+
+    auto ar1_paths = df::DataFrame<int>::simulate_ar1_paths(250, 4, 0.9, 1.0, 0.0, 100, 42);
+    df::print::print_frame(ar1_paths, "simulated AR(1) paths", false, 4);
+
+    auto garch_paths = df::DataFrame<int>::simulate_garch_paths(250, 4, 0.05, 0.10, 0.85, 0.0, 100, 42);
+    df::print::print_frame(garch_paths.column_stats_dataframe(), "simulated GARCH(1,1) path stats", false, 4);
   } catch (const std::exception& ex) {
     std::cerr << "x_construct error: " << ex.what() << "\n";
     return 1;
@@ -30,7 +30,29 @@ int main() {
                            false,
                            6);
 
+    auto multi_sorted = returns.sort_rows_by_columns({"TLT", "SPY"}, {false, true}).head_rows(5);
+    df::print::print_frame(multi_sorted.select_columns({"TLT", "SPY"}),
+                           "sorted by TLT desc, then SPY asc",
+                           false,
+                           6);
+
+    auto worst_spy_days = returns.nsmallest(3, "SPY");
+    df::print::print_frame(worst_spy_days.select_columns({"SPY", "EFA"}),
+                           "3 worst SPY days",
+                           false,
+                           6);
+    auto best_spy_days = returns.nlargest(3, "SPY");
+    df::print::print_frame(best_spy_days.select_columns({"SPY", "EFA"}),
+                           "3 best SPY days",
+                           false,
+                           6);
+
     if (!returns.index().empty()) {
+      auto top_columns = returns.top_k_columns(returns.index().back(), 3);
+      df::print::print_frame(top_columns.tail_rows(1),
+                             "top 3 columns on the last day",
+                             false,
+                             6);
       auto sorted_columns = returns.sort_columns_by_row(returns.index().front());
       df::print::print_frame(sorted_columns.head_rows(3),
                              "columns sorted by first row",
@@ -1,7 +1,11 @@
 #include "print_utils.h"
+#include "ring_buffer_frame.h"
 #include "sample_utils.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 int main() {
   try {
@@ -19,6 +23,73 @@ int main() {
 
     auto rolling = intraday.select_columns({"Close"}).rolling_mean(3).head_rows(3);
     df::print::print_frame(rolling, "3-period rolling mean", false, 6);
+
+    const std::vector<std::pair<std::string, df::Aggregation>> ohlcv = {
+        {"Open", df::Aggregation::first},
+        {"High", df::Aggregation::max},
+        {"Low", df::Aggregation::min},
+        {"Close", df::Aggregation::last},
+        {"Volume", df::Aggregation::sum}};
+    auto bars30 = intraday.resample_time(df::Duration::from_minutes(30), ohlcv);
+    df::print::print_frame(bars30, "30-minute OHLCV bars", false, 4);
+    auto daily = intraday.resample_time(df::Duration::from_days(1), ohlcv);
+    df::print::print_frame(daily, "daily OHLCV bars", false, 4);
+
+    // Simulate a live feed: append bars one at a time and let the operators
+    // process only the new rows on each tick.
+    auto closes = intraday.select_columns({"Close"});
+    auto live = closes.head_rows(0);
+    df::RollingOperator<df::DateTime> live_mean(3, df::RollingStatistic::mean);
+    df::EmaOperator<df::DateTime> live_ema(0.2);
+    for (std::size_t r = 0; r < closes.rows() && r < 6; ++r) {
+      live.append_row(closes.index()[r], {closes.value(r, 0)});
+      live_mean.update(live);
+      live_ema.update(live);
+    }
+    df::print::print_frame(live_mean.output(), "streaming 3-period rolling mean", false, 6);
+    df::print::print_frame(live_ema.output(), "streaming EMA(alpha=0.2)", false, 6);
+
+    // A feed thread writes into a fixed-capacity ring while this thread takes
+    // lock-free snapshots. Each one must be a contiguous run of feed rows with
+    // a strictly increasing index, however the two threads interleave.
+    auto bars = intraday.select_columns({"Close", "Volume"});
+    df::RingBufferFrame<df::DateTime> ring(64, bars.columns(), "Datetime");
+    std::atomic<bool> feeding{true};
+    std::thread feed([&]() {
+      for (std::size_t r = 0; r < bars.rows(); ++r) {
+        ring.append(bars.index()[r], {bars.value(r, 0), bars.value(r, 1)});
+      }
+      feeding.store(false);
+    });
+    std::size_t snapshots = 0;
+    std::size_t torn = 0;
+    while (feeding.load()) {
+      auto live_window = ring.snapshot();
+      ++snapshots;
+      if (live_window.rows() == 0) continue;
+      const auto& feed_index = bars.index();
+      const std::size_t first = static_cast<std::size_t>(
+          std::lower_bound(feed_index.begin(), feed_index.end(), live_window.index()[0]) -
+          feed_index.begin());
+      bool contiguous = first + live_window.rows() <= bars.rows();
+      for (std::size_t i = 0; contiguous && i < live_window.rows(); ++i) {
+        contiguous = live_window.index()[i] == feed_index[first + i] &&
+                     (i == 0 || live_window.index()[i - 1] < live_window.index()[i]) &&
+                     live_window.value(i, 0) == bars.value(first + i, 0) &&
+                     live_window.value(i, 1) == bars.value(first + i, 1);
+      }
+      if (!contiguous) ++torn;
+    }
+    feed.join();
+    std::cout << "\nconcurrent ring snapshots: " << (torn == 0 ? "all contiguous" : "TORN")
+              << (snapshots > 0 ? "" : " (feed finished first)") << "\n";
+    auto window = ring.snapshot();
+    std::cout << "ring buffer holds " << window.rows() << " of "
+              << ring.total_appended() << " appended bars\n";
+    df::print::print_frame(window.rolling_mean(12).tail_rows(3),
+                           "rolling mean over ring snapshot",
+                           false,
+                           6);
   } catch (const std::exception& ex) {
     std::cerr << "x_intraday warning: " << ex.what() << "\n";
     return 0;
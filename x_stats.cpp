@@ -2,6 +2,8 @@
 #include "sample_utils.h"
 
 #include <iostream>
+#include <thread>
+#include <vector>
 
 int main() {
   try {
@@ -22,6 +24,110 @@ int main() {
     auto cov = returns.covariance_matrix();
     df::print::print_frame(cov, "covariance matrix", false, 6);
 
+    auto recent = returns.tail_rows(8);
+    auto lw = recent.shrunk_covariance_matrix();
+    auto cc = recent.shrunk_covariance_matrix(df::ShrinkageTarget::constant_correlation);
+    std::cout << "\nshrinkage on last 8 rows: scaled identity " << lw.shrinkage
+              << ", constant correlation " << cc.shrinkage << "\n";
+    df::print::print_frame(lw.covariance, "Ledoit-Wolf covariance (last 8 rows)", false, 4);
+
+    auto acf = returns.select_columns({"SPY", "EFA", "TLT"}).autocorrelation_matrix(5);
+    df::print::print_frame(acf, "autocorrelations by lag", false, 3);
+
+    auto vol_input = returns.select_columns({"SPY", "TLT"});
+    auto garch_fits = vol_input.garch_fit_dataframe();
+    df::print::print_frame(garch_fits, "GARCH(1,1) fits", false, 4);
+    auto cond_sd = vol_input.garch_volatility(garch_fits);
+    df::print::print_frame(cond_sd, "GARCH conditional sd", false, 4);
+    auto standardized = vol_input.standardize_returns(cond_sd);
+    df::print::print_frame(standardized.column_stats_dataframe(), "GARCH-standardized returns", false, 4);
+
+    auto equity = prices.select_columns({"SPY", "TLT"}).pct_change().wealth_index(false, 100.0);
+    auto drawdown = equity.divide(equity.cummax()).subtract(1.0);
+    df::print::print_frame(equity.tail_rows(3), "wealth index (start 100)", false, 4);
+    df::print::print_frame(drawdown.cummin().tail_rows(1), "max drawdown", false, 4);
+
+    auto hedge = returns.ols("SPY", {"EFA", "TLT"});
+    df::print::print_frame(hedge.coefficients, "OLS: SPY on EFA, TLT", false, 4);
+    std::cout << "R^2 " << hedge.r_squared << ", residual sd " << hedge.residual_sd
+              << ", rows used " << hedge.n << "\n";
+    auto rolling_beta = returns.rolling_ols("SPY", {"EFA", "TLT"}, 252);
+    df::print::print_frame(rolling_beta.tail_rows(3), "rolling OLS (252 rows)", false, 4);
+
+    auto components = returns.pca(3);
+    df::print::print_frame(components.explained_variance, "PCA explained variance", false, 4);
+    df::print::print_frame(components.loadings, "PCA loadings", false, 3);
+    df::print::print_frame(components.scores.tail_rows(3), "PCA scores", false, 3);
+
+    std::vector<double> equal_weights(returns.cols(), 1.0 / static_cast<double>(returns.cols()));
+    auto portfolio = returns.dot(equal_weights, "equal_weight");
+    df::print::print_frame(portfolio.tail_rows(3), "equal-weight portfolio returns", false, 4);
+    auto factor_returns = returns.matmul(components.loadings);
+    df::print::print_frame(factor_returns.tail_rows(3), "returns x PCA loadings", false, 3);
+
+    auto cross_section = returns.select_columns({"SPY", "EFA", "EEM", "TLT", "HYG"}).tail_rows(3);
+    df::print::print_frame(cross_section.cross_sectional_rank(), "cross-sectional rank", false, 2);
+    df::print::print_frame(cross_section.cross_sectional_zscore(), "cross-sectional z-score", false, 3);
+    df::print::print_frame(cross_section.cross_sectional_demean(), "cross-sectional demean", false, 3);
+    df::print::print_frame(cross_section.cross_sectional_winsorize(20.0, 80.0),
+                           "cross-sectional winsorize (20%, 80%)",
+                           false,
+                           3);
+
+    auto ewm_cov = returns.select_columns({"SPY", "EFA", "TLT"}).ewm_cov_matrix(0.06);
+    df::print::print_frame(ewm_cov, "EWMA covariance (alpha=0.06)", false, 4);
+
+    // Feeding the growing frame twice, with one row fed on its own in
+    // between, must match one pass over all of it.
+    auto risk_returns = returns.select_columns({"SPY", "EFA", "TLT"});
+    auto live_returns = risk_returns.head_rows(risk_returns.rows() / 2);
+    df::EwmCovariance live_cov(risk_returns.columns(), 0.06);
+    live_cov.update(live_returns);
+    const std::size_t next = live_returns.rows();
+    const std::vector<double> next_row = {risk_returns.value(next, 0), risk_returns.value(next, 1),
+                                          risk_returns.value(next, 2)};
+    live_returns.append_row(risk_returns.index()[next], next_row);
+    live_cov.update(next_row);
+    live_returns.append_rows(risk_returns.tail_rows(risk_returns.rows() - live_returns.rows()));
+    live_cov.update(live_returns);
+    bool same_cov = live_cov.consumed() == risk_returns.rows();
+    for (std::size_t i = 0; i < 3; ++i) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        same_cov = same_cov && live_cov.covariance(i, j) == ewm_cov.value(i, j);
+      }
+    }
+    std::cout << "\nincremental EWMA covariance " << (same_cov ? "matches" : "differs from")
+              << " the one-shot result\n";
+
+    // Workers share one frozen copy of the returns instead of deep-copying it.
+    auto shared_returns = returns.share();
+    std::vector<double> worker_means(3, 0.0);
+    const std::vector<std::string> worker_columns = {"SPY", "EFA", "TLT"};
+    std::vector<std::thread> workers;
+    for (std::size_t w = 0; w < worker_columns.size(); ++w) {
+      workers.emplace_back([shared_returns, &worker_means, &worker_columns, w]() {
+        auto column_stats = shared_returns->select_columns({worker_columns[w]}).column_stats_dataframe();
+        worker_means[w] = column_stats.value(2, 0);
+      });
+    }
+    for (auto& worker : workers) worker.join();
+    std::cout << "\nmeans from workers sharing a frozen frame:";
+    for (std::size_t w = 0; w < worker_columns.size(); ++w) {
+      std::cout << ' ' << worker_columns[w] << '=' << worker_means[w];
+    }
+    std::cout << "\n";
+
+    df::BootstrapOptions boot_options;
+    boot_options.replicates = 200;
+    boot_options.method = df::BootstrapMethod::stationary;
+    boot_options.block_length = 20;
+    boot_options.seed = 42;
+    auto boot_means = returns.select_columns({"SPY", "EFA"}).bootstrap_column_means(boot_options);
+    df::print::print_column_percentiles(boot_means,
+                                        {2.5, 50, 97.5},
+                                        "stationary bootstrap of mean returns",
+                                        4);
+
     auto rolling = returns.rolling_mean(5).head_rows(3).select_columns({"SPY", "EFA"});
     df::print::print_frame(rolling, "5-day rolling mean", false, 6);
   } catch (const std::exception& ex) {